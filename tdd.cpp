@@ -20,16 +20,2231 @@
  * THE SOFTWARE.
  */
 
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#ifdef TDD_HOT_RELOAD
+#include <dlfcn.h>
+#endif
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#endif
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if TDD_ALLOCS
+#include <errno.h>
+#include <malloc.h>
+#endif
+
+#include "tdd.h"
+
+// Number of threads that run the runtime tests. 0 uses all cores. Overridden by the environment variable TDD_JOBS.
+#ifndef TDD_JOBS
+#define TDD_JOBS 1
+#endif
+
+// Number of worker processes that run the runtime tests, isolated from each other. 0 runs the tests in this process.
+// Overridden by the environment variable TDD_FORKS.
+#ifndef TDD_FORKS
+#define TDD_FORKS 0
+#endif
+
+// Number of slowest runtime tests listed after the run. Overridden by the environment variable TDD_SLOWEST.
+#ifndef TDD_SLOWEST
+#define TDD_SLOWEST 0
+#endif
+
+// A runtime test that takes longer than this many milliseconds is an error. 0 means no limit.
+// Overridden by the environment variable TDD_BUDGET_MS.
+#ifndef TDD_BUDGET_MS
+#define TDD_BUDGET_MS 0
+#endif
+
+// A runtime test that runs longer than this many milliseconds is reported with a backtrace and cancelled. If it does not
+// return within the same time again, the run ends with exit status 124. With TDD_FORKS, its worker is killed instead and
+// the run continues. 0 means no limit. Overridden by the environment variable TDD_TIMEOUT_MS, and by tdd::timeout_ms().
+#ifndef TDD_TIMEOUT_MS
+#define TDD_TIMEOUT_MS 0
+#endif
+
+// What a runtime test prints is kept in a ring buffer of this many KiB per thread, and printed when the test ends, below
+// its name. If the test printed more, only the end is kept. 0 prints immediately.
+// Overridden by the environment variable TDD_LOG_KB.
+#ifndef TDD_LOG_KB
+#define TDD_LOG_KB 1024
+#endif
+
+// Drops what passing runtime tests printed if this is not 0. Overridden by the environment variable TDD_QUIET.
+#ifndef TDD_QUIET
+#define TDD_QUIET 0
+#endif
+
+// Number of random cases per PROPERTY, and the seed they are drawn from. 0 seeds from the clock.
+// Overridden by the environment variables TDD_CASES and TDD_SEED.
+#ifndef TDD_CASES
+#define TDD_CASES 10000
+#endif
+#ifndef TDD_SEED
+#define TDD_SEED 0
+#endif
+
+// Replaces malloc, free and the rest of their family with versions that count the allocations of every thread, so that
+// each runtime test lists its allocations after the run, and EXPECT_NO_ALLOC and EXPECT_MAX_ALLOCS work. operator new
+// and delete are counted through them, as the standard library's call malloc and free. Needs glibc.
+#ifndef TDD_ALLOCS
+#define TDD_ALLOCS 0
+#endif
+
+// Counts cycles, instructions, branch and cache misses and page faults of every runtime test and benchmark if this is
+// not 0, or task clock and page faults without hardware counters. Overridden by the environment variable TDD_PERF.
+#ifndef TDD_PERF
+#define TDD_PERF 0
+#endif
+
+// File that keeps the durations of runtime tests and the samples of benchmarks of every run, to compare new runs with.
+// "" keeps none. A result that is more than TDD_REGRESSION percent slower than before, significantly, is an error.
+// Overridden by the environment variables TDD_HISTORY and TDD_REGRESSION.
+#ifndef TDD_HISTORY
+#define TDD_HISTORY ""
+#endif
+#ifndef TDD_REGRESSION
+#define TDD_REGRESSION 10
+#endif
+
+// Benchmarks only run if this is not 0. Overridden by the environment variable TDD_BENCH.
+#ifndef TDD_BENCH
+#define TDD_BENCH 0
+#endif
+
+// Number of timed samples per benchmark, and the minimum duration of one sample in milliseconds.
+#ifndef TDD_BENCH_SAMPLES
+#define TDD_BENCH_SAMPLES 15
+#endif
+#ifndef TDD_BENCH_SAMPLE_MS
+#define TDD_BENCH_SAMPLE_MS 10
+#endif
 
 namespace tdd::_internal_tdd  {
 	unsigned errors = 0;
-	unsigned completed = 0;
+	unsigned long long bench_iterations = 1;
+
+	static unsigned long long now() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	static void timed_call(test_case* t) {
+		unsigned long long start = now();
+		t->call();
+		t->ns = now() - start;
+	}
+
+	// Test parameters as spelled by the compiler in type_names(), e.g. "int, const A&". Empty for plain tests.
+	static int params_of(const test_case* t, const char*& begin) {
+		const char* p = strstr(t->params, "T = ");
+		const char* end = p ? strrchr(p, ']') : nullptr;
+		if (!end) return 0;
+		p += 4;
+		if (*p == '{' || *p == '<') { ++p; --end; }  // GCC: {int, char}, Clang: <int, char>
+		if (end - p == 4 && !strncmp(p, "void", 4)) return 0;
+		begin = p;
+		return (int)(end - p);
+	}
+
+	static const char* describe(const test_case* t, char* buf, size_t size) {
+		const char* p;
+		int n = params_of(t, p);
+		if (!n) return t->info->name;
+		snprintf(buf, size, "%s<%.*s>", t->info->name, n, p);
+		return buf;
+	}
+
+	static unsigned env_count(const char* name, long n, bool zero_is_all) {
+		if (const char* env = getenv(name)) n = atol(env);
+		if (n <= 0 && zero_is_all) n = sysconf(_SC_NPROCESSORS_ONLN);
+		return n > 0 ? (unsigned)n : 0;
+	}
+
+	static double median(double* v, unsigned n) {  // Sorts v.
+		for (unsigned i = 1; i < n; ++i)
+			for (unsigned k = i; k && v[k - 1] > v[k]; --k) { double x = v[k]; v[k] = v[k - 1]; v[k - 1] = x; }
+		return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+	}
+
+	// counters {{{
+	// A thread enlists its counters the first time it counts something. When it exits, they are added to exited.
+	thread_local constinit counters counts{};
+
+	static counters exited;
+	static counters* live;
+	static pthread_mutex_t counters_lock = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_key_t counters_key;
+
+	static void fold(void* p) {
+		counters* c = (counters*)p;
+		pthread_mutex_lock(&counters_lock);
+		exited.passed += c->passed;
+		exited.failed += c->failed;
+		exited.completed += c->completed;
+		counters** i = &live;
+		while (*i != c) i = &(*i)->next;
+		*i = c->next;
+		pthread_mutex_unlock(&counters_lock);
+	}
+
+	void enlist(counters* c) noexcept {
+		static pthread_once_t once = PTHREAD_ONCE_INIT;
+		pthread_once(&once, []{ pthread_key_create(&counters_key, fold); });
+		pthread_setspecific(counters_key, c);  // fold() runs at thread exit, but not for the main thread.
+		pthread_mutex_lock(&counters_lock);
+		c->next = live;
+		live = c;
+		c->enlisted = true;
+		pthread_mutex_unlock(&counters_lock);
+	}
+
+	static counters totals() {
+		pthread_mutex_lock(&counters_lock);
+		counters t = exited;
+		for (counters* c = live; c; c = c->next) {
+			t.passed += __atomic_load_n(&c->passed, __ATOMIC_RELAXED);
+			t.failed += __atomic_load_n(&c->failed, __ATOMIC_RELAXED);
+			t.completed += __atomic_load_n(&c->completed, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&counters_lock);
+		return t;
+	}
+	// }}}
+	// allocations {{{
+	thread_local constinit alloc_counts allocs = {};
+
+	#if TDD_ALLOCS
+	static void* counted(void* p, size_t n) noexcept {
+		if (!p) return p;
+		alloc_counts& a = allocs;
+		a.count++;
+		a.bytes += n;
+		a.live += malloc_usable_size(p);
+		if (a.live > a.peak) a.peak = a.live;
+		return p;
+	}
+
+	static void uncounted(void* p) noexcept { if (p) allocs.live -= malloc_usable_size(p); }
+	#endif
+	// }}}
+	// choices {{{
+	// What the current PROPERTY case chose, in order. See run_property().
+	struct choices {
+		unsigned long long* v;
+		unsigned n, cap;
+		const unsigned long long* replay;  // nullptr while searching.
+		unsigned replay_n;
+		unsigned long long rng;
+		bool active;                       // In a PROPERTY.
+		bool probing;                      // Failures only set failed and count, quietly.
+		bool failed;
+	};
+
+	static thread_local choices current_choices;
+	thread_local constinit bool showing = false;
+
+	static unsigned long long next_random(unsigned long long& s) {  // splitmix64
+		unsigned long long z = (s += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	unsigned long long choose(unsigned long long max) noexcept {
+		choices& c = current_choices;
+		unsigned long long x;
+		if (c.replay) x = c.n >= c.replay_n ? 0 : c.replay[c.n] < max ? c.replay[c.n] : max;  // Past the end, the simplest.
+		else {
+			unsigned bits = next_random(c.rng) % 65;  // Magnitudes spread evenly, so that small values are common.
+			unsigned long long bound = bits < 64 && max >> bits ? (1ull << bits) - 1 : max;
+			x = next_random(c.rng);
+			if (bound != ~0ull) x %= bound + 1;
+		}
+		if (!c.active) return x;
+
+		if (c.n == c.cap) {
+			c.cap = c.cap ? 2 * c.cap : 64;
+			if (!(c.v = (unsigned long long*)realloc(c.v, c.cap * sizeof *c.v))) { perror("tdd"); exit(1); }
+		}
+		c.v[c.n++] = x;
+		return x;
+	}
+	// }}}
+	// log {{{
+	// A runtime test prints into a ring buffer of its thread, without locks, and the thread writes it out in one
+	// writev() when the test ends, below the test's name. Helper threads of a test do the same when they end.
+	struct log_ring {
+		char* data;                  // The ring, then as much again to format into.
+		size_t cap;
+		unsigned long long written;  // Since the test began. The last cap bytes are kept.
+		const test_case* test;       // Printing into the ring, or nullptr.
+	};
+
+	static size_t log_cap;  // 0 prints immediately.
+	static bool log_quiet;
+	static pthread_key_t log_key;
+	static thread_local log_ring ring;
+
+	static void unmap_ring(void* p) {  // At thread exit.
+		log_ring* r = (log_ring*)p;
+		munmap(r->data, 2 * r->cap);
+		r->data = nullptr;
+	}
+
+	static bool map_ring(log_ring& r) {
+		static pthread_once_t once = PTHREAD_ONCE_INIT;
+		pthread_once(&once, []{ pthread_key_create(&log_key, unmap_ring); });
+		void* m = mmap(nullptr, 2 * log_cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);  // Not counted by TDD_ALLOCS.
+		if (m == MAP_FAILED) return false;
+		r.data = (char*)m;
+		r.cap = log_cap;
+		pthread_setspecific(log_key, &r);
+		return true;
+	}
+
+	// Also called from signal handlers, on the thread that crashed or timed out.
+	static void flush_ring(log_ring& r) {
+		char tag[600], name[512], dropped[64];
+		const test_case* t = r.test;
+		iovec v[4];
+		int n = 0;
+		v[n++] = {tag, (size_t)snprintf(tag, sizeof tag, "\x1B[1m%s:%u: %s:\x1B[0m\n", t->info->file, t->info->line, describe(t, name, sizeof name))};
+		if (r.written <= r.cap) v[n++] = {r.data, (size_t)r.written};
+		else {
+			size_t at = r.written % r.cap, skip = 0;
+			while (skip < r.cap && r.data[(at + skip) % r.cap] != '\n') ++skip;  // From the first whole line, if any.
+			skip = skip + 1 < r.cap ? skip + 1 : 0;
+			v[n++] = {dropped, (size_t)snprintf(dropped, sizeof dropped, "    ... %llu bytes dropped\n", r.written - r.cap + skip)};
+			at = (at + skip) % r.cap;
+			if (at >= r.written % r.cap) {
+				v[n++] = {r.data + at, r.cap - at};
+				v[n++] = {r.data, r.written % r.cap};
+			}
+			else v[n++] = {r.data + at, r.written % r.cap - at};
+		}
+		for (iovec* i = v; n;) {  // Once, unless the write is partial.
+			ssize_t k = writev(2, i, n);
+			if (k < 0) return;
+			for (; n && (size_t)k >= i->iov_len; --n) k -= (i++)->iov_len;
+			if (n) { i->iov_base = (char*)i->iov_base + k; i->iov_len -= k; }
+		}
+		r.written = 0;
+	}
+
+	static void log_begin(const test_case* t) {
+		if (log_cap) ring.test = t;
+	}
+
+	static void log_end(bool keep) {
+		log_ring& r = ring;
+		if (r.test && r.written && keep) flush_ring(r);
+		r.written = 0;
+		r.test = nullptr;
+	}
+
+	void print(const char* format, ...) noexcept {
+		va_list args;
+		va_start(args, format);
+		log_ring& r = ring;
+		if (r.test && (r.data || map_ring(r))) {
+			int n = vsnprintf(r.data + r.cap, r.cap, format, args);
+			size_t len = n < 0 ? 0 : (size_t)n < r.cap ? n : r.cap - 1;  // Truncated to the ring.
+			size_t at = r.written % r.cap, first = len < r.cap - at ? len : r.cap - at;
+			memcpy(r.data + at, r.data + r.cap, first);
+			memcpy(r.data, r.data + r.cap + first, len - first);
+			r.written += len;
+		}
+		else vfprintf(stderr, format, args);
+		va_end(args);
+	}
+
+	static void flush_on_crash(int) {  // Then the signal does what it would have done.
+		if (ring.test && ring.written) flush_ring(ring);
+	}
+
+	static void catch_crash_signals() {
+		static const int fatal[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+		for (int s : fatal) {
+			struct sigaction sa = {}, old;
+			if (sigaction(s, nullptr, &old) || old.sa_handler != SIG_DFL) continue;  // The program's own.
+			sa.sa_handler = flush_on_crash;
+			sa.sa_flags = SA_RESETHAND | SA_NODEFER;
+			sigaction(s, &sa, nullptr);
+		}
+	}
+	// }}}
+	// failures {{{
+	struct failure {
+		const char* file;  // nullptr if the test exceeded its time budget.
+		size_t line;
+		const char* msg;
+	};
+
+	constexpr unsigned max_failures = 8;  // Kept per test for the report; all are counted and printed.
+
+	static thread_local failure failures[max_failures];
+	static thread_local unsigned failure_count;
+
+	static void record_failure(failure f) {
+		if (failure_count < max_failures) failures[failure_count] = f;
+		++failure_count;
+	}
+
+	static void stop_worker();
+
+	bool fail(const char* file, size_t line, const char* msg, unsigned max_errors) noexcept {
+		if (current_choices.probing) {  // An assertion like the passing ones, but no error.
+			current_choices.failed = true;
+			tally(counts.failed);
+			return false;
+		}
+		print("\x1B[1m%s:%lu: \x1B[31merror:\x1B[0m expected %s\n", file, line, msg);
+		record_failure({file, line, msg});
+		tally(counts.failed);
+		if (max_errors == (__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED) + 1)) {
+			log_end(true);
+			stop_worker();
+			exit(errors);
+		}
+		return true;
+	}
+	// }}}
+	// ranges {{{
+	static size_t mismatch_words(const unsigned char* a, const unsigned char* b, size_t i, size_t n) {
+		for (unsigned long long x, y; i + 8 <= n; i += 8) {
+			memcpy(&x, a + i, 8);
+			memcpy(&y, b + i, 8);
+			if (x != y) break;
+		}
+		while (i < n && a[i] == b[i]) ++i;
+		return i;
+	}
+
+	#if defined(__x86_64__)
+	[[gnu::target("avx2")]] static inline __m256i diff_avx2(const unsigned char* a, const unsigned char* b) {
+		return _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)a), _mm256_loadu_si256((const __m256i*)b));
+	}
+
+	[[gnu::target("avx2")]] static size_t mismatch_avx2(const unsigned char* a, const unsigned char* b, size_t n) {
+		size_t i = 0;
+		for (; i + 128 <= n; i += 128) {  // One branch per 128 bytes.
+			__m256i d = _mm256_or_si256(_mm256_or_si256(diff_avx2(a + i, b + i), diff_avx2(a + i + 32, b + i + 32)),
+			                            _mm256_or_si256(diff_avx2(a + i + 64, b + i + 64), diff_avx2(a + i + 96, b + i + 96)));
+			if (!_mm256_testz_si256(d, d)) break;
+		}
+		for (; i + 32 <= n; i += 32) {
+			unsigned m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(diff_avx2(a + i, b + i), _mm256_setzero_si256()));
+			if (m) return i + __builtin_ctz(m);
+		}
+		return mismatch_words(a, b, i, n);
+	}
+
+	static inline __m128i same_sse2(const unsigned char* a, const unsigned char* b) {
+		return _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+	}
+
+	static size_t mismatch_sse2(const unsigned char* a, const unsigned char* b, size_t n) {
+		size_t i = 0;
+		for (; i + 64 <= n; i += 64) {
+			__m128i e = _mm_and_si128(_mm_and_si128(same_sse2(a + i, b + i), same_sse2(a + i + 16, b + i + 16)),
+			                          _mm_and_si128(same_sse2(a + i + 32, b + i + 32), same_sse2(a + i + 48, b + i + 48)));
+			if (_mm_movemask_epi8(e) != 0xFFFF) break;
+		}
+		for (; i + 16 <= n; i += 16) {
+			unsigned m = ~(unsigned)_mm_movemask_epi8(same_sse2(a + i, b + i)) & 0xFFFF;
+			if (m) return i + __builtin_ctz(m);
+		}
+		return mismatch_words(a, b, i, n);
+	}
+
+	static bool has_avx2() {
+		static const bool yes = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));  // Also before static constructors.
+		return yes;
+	}
+
+	static auto pick_mismatch() { return has_avx2() ? mismatch_avx2 : mismatch_sse2; }
+	#else
+	static auto pick_mismatch() {
+		return +[](const unsigned char* a, const unsigned char* b, size_t n) { return mismatch_words(a, b, 0, n); };
+	}
+	#endif
+
+	size_t mismatch(const void* a, const void* b, size_t n) noexcept {
+		static const auto kernel = pick_mismatch();
+		return kernel((const unsigned char*)a, (const unsigned char*)b, n);
+	}
+
+	size_t count_mismatches(const void* a, const void* b, size_t n, size_t size, size_t first) noexcept {
+		const char* x = (const char*)a;
+		const char* y = (const char*)b;
+		size_t count = 0;
+		for (size_t i = first; i < n; ++i) {
+			i += mismatch(x + i * size, y + i * size, (n - i) * size) / size;
+			count += i < n;
+		}
+		return count;
+	}
+
+	static long double real_of(const unsigned char* p, size_t size) {
+		if (size == sizeof(float))  { float f;  memcpy(&f, p, size); return f; }
+		if (size == sizeof(double)) { double d; memcpy(&d, p, size); return d; }
+		long double l;
+		memcpy(&l, p, sizeof l);
+		return l;
+	}
+
+	static int element_width(size_t size, element e) {
+		switch (e) {
+		case element::real: return size == sizeof(float) ? 15 : 24;
+		case element::sint:
+		case element::uint: return size == 2 ? 6 : size == 4 ? 11 : 20;
+		default:            return 2 * (int)size;
+		}
+	}
+
+	static void print_element(const unsigned char* p, size_t size, element e, int width) {
+		unsigned long long u = 0;
+		if (e == element::sint || e == element::uint) memcpy(&u, p, size);  // Little endian.
+		unsigned shift = 64 - 8 * (unsigned)size;
+		switch (e) {
+		case element::real: print(" %*.*Lg", width, size == sizeof(float) ? 9 : 17, real_of(p, size)); break;
+		case element::sint: print(" %*lld", width, (long long)(u << shift) >> shift); break;
+		case element::uint: print(" %*llu", width, u); break;
+		case element::hex:
+			print(" ");
+			for (size_t k = 0; k < size; ++k) print("%02x", p[k]);
+		}
+	}
+
+	void print_mismatch(const void* a, size_t na, const void* b, size_t nb, size_t size, element e,
+	                    bool (*equal)(const void*, const void*, size_t), size_t first, size_t count) noexcept {
+		const unsigned char* x = (const unsigned char*)a;
+		const unsigned char* y = (const unsigned char*)b;
+		size_t n = na > nb ? na : nb;
+		if (na != nb) print("    sizes differ: %zu and %zu\n", na, nb);
+		if (count) print("    %zu of %zu elements differ, the first at %zu\n", count, na < nb ? na : nb, first);
+
+		int width = element_width(size, e);
+		size_t per_row = e == element::hex ? (size < 16 ? 16 / size : 1) : 64 / (width + 1);
+		int digits = snprintf(nullptr, 0, "%zu", n);
+		size_t row = first / per_row;
+		size_t from = (row ? row - 1 : 0) * per_row, to = (row + 3) * per_row;
+		if (to > n) to = n;
+
+		auto differs = [&](size_t i) { return i >= na || i >= nb || !equal(a, b, i); };
+		for (size_t r = from; r < to; r += per_row) {
+			size_t end = r + per_row < to ? r + per_row : to;
+			for (int side = 0; side < 2; ++side) {
+				const unsigned char* p = side ? y : x;
+				print("    %c[%*zu]", side ? 'b' : 'a', digits, r);
+				for (size_t i = r; i < end && i < (side ? nb : na); ++i) print_element(p + i * size, size, e, width);
+				print("\n");
+			}
+			size_t marked = r;  // Up to the last mismatch of the row.
+			for (size_t i = r; i < end; ++i) if (differs(i)) marked = i + 1;
+			if (marked == r) continue;
+			char carets[256];  // Printed in pieces if the row is wider.
+			size_t len = 0;
+			print("    %*s", digits + 3, "");
+			for (size_t i = r; i < marked; ++i)
+				for (int k = 0; k <= width; ++k) {
+					carets[len++] = k && differs(i) ? '^' : ' ';
+					if (len == sizeof carets - 1) { carets[len] = 0; print("%s", carets); len = 0; }
+				}
+			carets[len] = 0;
+			print("%s\n", carets);
+		}
+	}
+	// }}}
+	// floats {{{
+	template<class T>
+	static size_t first_off_scalar(const T* a, const T* b, size_t n, tolerance t, double tol) {
+		size_t i = 0;
+		while (i < n && within(a[i], b[i], t, tol)) ++i;
+		return i;
+	}
+
+	#if defined(__x86_64__)
+	template<class T>
+	struct lanes {  // 8 floats or 4 doubles, and as many integers of the same size.
+		using I = conditional<sizeof(T) == 4, int, long long>;
+		typedef T V [[gnu::vector_size(32)]];
+		typedef I M [[gnu::vector_size(32)]];
+	};
+
+	// Exactly within() on one vector, with GCC vector extensions. All bits of a lane are set if it is.
+	template<class T, tolerance t, class L = lanes<T>, class I = typename L::I, class V = typename L::V, class M = typename L::M>
+	[[gnu::target("avx2")]] [[gnu::always_inline]] inline M within_avx2(const T* a, const T* b, V vt, M mt) {
+		constexpr int bits = 8 * sizeof(T);
+		constexpr I max = I(~0ull >> (65 - bits));
+		V x, y;
+		memcpy(&x, a, sizeof x);
+		memcpy(&y, b, sizeof y);
+		M same = (x == y) | ((x != x) & (y != y));
+		if constexpr(t == tolerance::abs) {
+			V d = x - y;
+			return same | ((d <= vt) & (-d <= vt));
+		} else {  // Ordered like the values: negative ones count down from 0.
+			M i, j;
+			memcpy(&i, &x, sizeof i);
+			memcpy(&j, &y, sizeof j);
+			M si = i >> (bits - 1), sj = j >> (bits - 1);
+			M d = ((i ^ (si & max)) - si) - ((j ^ (sj & max)) - sj);
+			return same | ((d <= mt) & (d >= -mt) & (x - x == 0) & (y - y == 0));  // Both finite.
+		}
+	}
+
+	template<class T, tolerance t>
+	[[gnu::target("avx2")]] static size_t first_off_avx2(const T* a, const T* b, size_t n, double tol) {
+		using L = lanes<T>;
+		constexpr size_t w = 32 / sizeof(T);
+		if (t == tolerance::ulps && tol >= double(1ull << (sizeof(T) == 4 ? 23 : 52)))  // Distances could wrap around.
+			return first_off_scalar(a, b, n, t, tol);
+
+		typename L::V vt = typename L::V{} + T(tol);
+		typename L::M mt = typename L::M{} + typename L::I(tol);
+		size_t i = 0;
+		for (; i + 2 * w <= n; i += 2 * w) {
+			typename L::M ok = within_avx2<T, t>(a + i, b + i, vt, mt) & within_avx2<T, t>(a + i + w, b + i + w, vt, mt);
+			if (_mm256_movemask_epi8((__m256i)ok) != -1) break;
+		}
+		return i + first_off_scalar(a + i, b + i, n - i, t, tol);
+	}
+	#endif
+
+	template<class T>
+	size_t first_off(const T* a, const T* b, size_t n, tolerance t, double tol) noexcept {
+		#if defined(__x86_64__)
+		if constexpr(sizeof(T) <= 8) if (has_avx2()) {
+			if (t == tolerance::abs) return first_off_avx2<T, tolerance::abs>(a, b, n, tol);
+			return first_off_avx2<T, tolerance::ulps>(a, b, n, tol);
+		}
+		#endif
+		return first_off_scalar(a, b, n, t, tol);
+	}
+
+	template<class T>
+	void print_off(const T* a, const T* b, size_t n, tolerance t, double tol) noexcept {
+		const char* unit = t == tolerance::ulps ? " ulps" : "";
+		int digits = sizeof(T) == sizeof(float) ? 9 : sizeof(T) == sizeof(double) ? 17 : 21;
+		auto error = [&](size_t i) {  // Infinite for NaN or infinity against anything else.
+			T x = a[i], y = b[i];
+			if (within(x, y, tolerance::abs, 0)) return 0.0;
+			if (!(x - x == 0 && y - y == 0)) return (double)INFINITY;
+			if (t == tolerance::abs) return (double)(x < y ? y - x : x - y);
+			if constexpr(sizeof(T) <= 8) return (double)ulps_between(x, y);
+			else return (double)INFINITY;
+		};
+
+		size_t off = 0, infinite = 0, worst = 0;
+		double worst_error = -1, smallest = INFINITY;
+		for (size_t i = 0; i < n; ++i) {
+			double e = error(i);
+			if (!within(a[i], b[i], t, tol)) off++, infinite += e == INFINITY;
+			if (e > worst_error) worst = i, worst_error = e;
+			if (e > 0 && e < smallest) smallest = e;
+		}
+		const char* worst_unit = worst_error == INFINITY ? "" : unit;
+		if (n == 1) {
+			print("    %.*Lg and %.*Lg, off by %g%s\n", digits, (long double)a[0], digits, (long double)b[0], worst_error, worst_unit);
+			return;
+		}
+		print("    %zu of %zu elements off", off, n);
+		if (infinite) print(", %zu of them NaN or infinite", infinite);
+		print("\n    worst at %zu: %.*Lg and %.*Lg, off by %g%s\n", worst,
+		      digits, (long double)a[worst], digits, (long double)b[worst], worst_error, worst_unit);
+
+		// Errors in powers of 2 of the tolerance, or of the smallest error without one.
+		constexpr int buckets = 66;
+		size_t histogram[buckets] = {};
+		double base = tol > 0 ? tol : smallest;
+		for (size_t i = 0; i < n; ++i) {
+			double e = error(i);
+			double k = e == 0 ? 0 : e == INFINITY ? buckets - 1 : e <= base ? 1 : 1 + ceil(log2(e / base));
+			histogram[k < buckets - 2 ? (int)k : k == buckets - 1 ? buckets - 1 : buckets - 2]++;
+		}
+		print("    errors up to\n");
+		for (int k = 0; k < buckets; ++k) {
+			if (!histogram[k]) continue;
+			char label[32] = "0";
+			if (k == buckets - 1)      strcpy(label, "NaN or infinite");
+			else if (k == buckets - 2) strcpy(label, "more");
+			else if (k)                snprintf(label, sizeof label, "%g%s", ldexp(base, k - 1), unit);
+			print("        %-16s %12zu%s\n", label, histogram[k], k == 1 && tol > 0 ? "  (tolerance)" : "");
+		}
+	}
+
+	template size_t first_off(const float*, const float*, size_t, tolerance, double) noexcept;
+	template size_t first_off(const double*, const double*, size_t, tolerance, double) noexcept;
+	template size_t first_off(const long double*, const long double*, size_t, tolerance, double) noexcept;
+	template void print_off(const float*, const float*, size_t, tolerance, double) noexcept;
+	template void print_off(const double*, const double*, size_t, tolerance, double) noexcept;
+	template void print_off(const long double*, const long double*, size_t, tolerance, double) noexcept;
+	// }}}
+	// report {{{
+	// TDD_REPORT=jsonl[:fd] or junit[:fd] streams one record per runtime test instantiation to fd, by default stdout.
+	// Records are formatted per thread and appended to a shared buffer that is written in large blocks.
+	enum class format { none, jsonl, junit };
+
+	static format report_format = format::none;
+	static int report_fd = 1;
+	static bool report_sync = false;  // Write every record immediately, in worker processes.
+	static char report_buf[1 << 16];
+	static size_t report_len = 0;
+	static pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+
+	struct record {
+		char data[8192];
+		size_t len = 0;
+		size_t room = sizeof data - 2048;  // For escaped strings. The rest is kept to close the record.
+		bool cut = false;                  // A string did not fit, and ends early.
+
+		void add(const char* s, size_t n) {
+			if (n > sizeof data - len) n = sizeof data - len;
+			memcpy(data + len, s, n);
+			len += n;
+		}
+		void add(const char* s) { add(s, strlen(s)); }
+
+		template<class... Args>
+		void addf(const char* fmt, Args... args) {
+			size_t left = sizeof data - len;
+			int n = snprintf(data + len, left, fmt, args...);
+			if (n > 0 && left) len += (size_t)n < left ? n : left - 1;
+		}
+
+		// Stops before the first character that would go past room, and before the UTF-8 sequence it is part of.
+		void escaped(const char* s, size_t n = ~size_t(0)) {
+			for (; n && *s; ++s, --n) {
+				unsigned char c = *s;
+				char e[8] = {*s};
+				int k = 1;
+				if (report_format == format::junit) {
+					if      (c == '<')  k = snprintf(e, sizeof e, "&lt;");
+					else if (c == '>')  k = snprintf(e, sizeof e, "&gt;");
+					else if (c == '&')  k = snprintf(e, sizeof e, "&amp;");
+					else if (c == '"')  k = snprintf(e, sizeof e, "&quot;");
+					else if (c < 0x20 && c != '\n' && c != '\t') k = 0;
+				} else {
+					if      (c == '"' || c == '\\') k = snprintf(e, sizeof e, "\\%c", c);
+					else if (c == '\n') k = snprintf(e, sizeof e, "\\n");
+					else if (c < 0x20)  k = snprintf(e, sizeof e, "\\u%04x", c);
+				}
+				if (len + k > room) {
+					if ((c & 0xC0) == 0x80)  // Inside a sequence: drop its first bytes too.
+						while (len && (unsigned char)data[len - 1] >= 0x80 && (data[--len] & 0xC0) == 0x80) {}
+					cut = true;
+					return;
+				}
+				add(e, k);
+			}
+		}
+	};
+
+	static void report_flush() {  // Lock held, or single threaded.
+		for (size_t done = 0; done < report_len;) {
+			ssize_t n = write(report_fd, report_buf + done, report_len - done);
+			if (n <= 0) break;
+			done += n;
+		}
+		report_len = 0;
+	}
+
+	static void report_write(const char* s, size_t n) {
+		pthread_mutex_lock(&report_lock);
+		if (report_len + n > sizeof report_buf) report_flush();
+		memcpy(report_buf + report_len, s, n);
+		report_len += n;
+		if (report_sync) report_flush();
+		pthread_mutex_unlock(&report_lock);
+	}
+
+	static void report_close() {
+		if (report_format == format::junit && !report_sync)  // Not from a worker process that exits early.
+			report_write("</testsuite>\n</testsuites>\n", 27);
+		pthread_mutex_lock(&report_lock);
+		report_flush();
+		pthread_mutex_unlock(&report_lock);
+	}
+
+	static void report_open() {
+		const char* env = getenv("TDD_REPORT");
+		if (!env) return;
+		if      (!strncmp(env, "jsonl", 5)) report_format = format::jsonl;
+		else if (!strncmp(env, "junit", 5)) report_format = format::junit;
+		else {
+			fprintf(stderr, "TDD_REPORT must be jsonl[:fd] or junit[:fd]\n");
+			exit(1);
+		}
+		if (env[5] == ':') report_fd = atoi(env + 6);
+
+		if (report_format == format::junit) {
+			const char* header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n<testsuite name=\"tdd\">\n";
+			report_write(header, strlen(header));
+		}
+		atexit(report_close);  // Also when TDD_MAX_ERRORS is reached.
+	}
+
+	// The summary goes to stderr if the report takes stdout.
+	static FILE* text_out() { return report_format != format::none && report_fd == 1 ? stderr : stdout; }
+
+	static void report(const test_case* t, const char* status, const failure* f, unsigned nf, const char* extra = "") {
+		if (report_format == format::none) return;
+		if (nf > max_failures) nf = max_failures;
+
+		static thread_local record r, lines;
+		r.len = 0;
+		r.cut = false;
+		const char* params = "";
+		int params_len = params_of(t, params);
+
+		// Failures that do not fit are left out whole, and the record says it is truncated.
+		if (report_format == format::jsonl) {
+			r.add("{\"name\":\"");     r.escaped(t->info->name);
+			r.add("\",\"params\":\""); r.escaped(params, params_len);
+			r.addf("\",\"status\":\"%s\",\"ns\":%llu%s", status, t->ns, extra);
+			if (nf) {
+				r.add(",\"failures\":[");
+				for (unsigned i = 0; i < nf; ++i) {
+					size_t before = r.len;
+					r.add(i ? ",{\"file\":\"" : "{\"file\":\""); r.escaped(f[i].file ? f[i].file : "");
+					r.addf("\",\"line\":%lu,\"message\":\"", f[i].line);
+					r.escaped(f[i].msg);
+					r.add("\"}");
+					if (r.cut || r.len > r.room) { r.len = before; r.cut = true; break; }
+				}
+				r.add("]");
+			}
+			r.add(r.cut ? ",\"truncated\":true}\n" : "}\n");
+		} else {
+			r.add("<testcase classname=\"tdd\" name=\""); r.escaped(t->info->name);
+			if (params_len) { r.add("&lt;"); r.escaped(params, params_len); r.add("&gt;"); }
+			r.addf("\" time=\"%.9f\"", t->ns / 1e9);
+			if (!nf) r.add(r.cut ? " truncated=\"true\"/>\n" : "/>\n");
+			else {
+				r.add("><failure message=\""); r.escaped(f[0].msg); r.add("\"");
+				lines.len = 0;
+				lines.cut = false;
+				lines.room = r.room > r.len ? r.room - r.len : 0;
+				for (unsigned i = 0; i < nf; ++i) {
+					size_t before = lines.len;
+					if (f[i].file) { lines.escaped(f[i].file); lines.addf(":%lu: ", f[i].line); }
+					lines.escaped(f[i].msg);
+					lines.add("\n");
+					if (lines.cut || lines.len > lines.room) { lines.len = before; r.cut = true; break; }
+				}
+				r.add(r.cut ? " truncated=\"true\">" : ">");
+				r.add(lines.data, lines.len);
+				r.add("</failure></testcase>\n");
+			}
+		}
+		report_write(r.data, r.len);
+	}
+	// }}}
+
+	// watchdog {{{
+	// Every thread that runs tests has a watch. A watchdog thread looks at them every 10ms, and when a test exceeds its
+	// limit, prints it with the backtrace of its thread and cancels it. tdd::cancelled() lets the test give up early; if
+	// it has not returned after as long again, the whole run is given up.
+	constexpr int timeout_status = 124;  // Like timeout(1).
+
+	struct watch {
+		test_case* test;                  // Running, or nullptr.
+		unsigned long long start, limit;  // ns, limit 0 for none.
+		bool cancelled;
+		pthread_t thread;
+	};
+
+	static unsigned long long default_timeout;  // ns
+	static watch* watches;
+	static unsigned watch_count;
+	static thread_local watch* current_watch;
+	static bool watchdog_running, watchdog_stop;
+	static pthread_t watchdog_thread;
+	static pthread_mutex_t watchdog_lock = PTHREAD_MUTEX_INITIALIZER;
+
+	static void print_backtrace(int) {
+		if (ring.test && ring.written) flush_ring(ring);  // What the test printed so far, before it may get killed.
+	#if __has_include(<execinfo.h>)
+		void* frames[64];
+		backtrace_symbols_fd(frames, backtrace(frames, 64), 2);
+	#endif
+	}
+
+	static void catch_backtrace_signal() {
+	#if __has_include(<execinfo.h>)
+		void* frame;
+		backtrace(&frame, 1);  // Loads libgcc here rather than in the signal handler.
+	#endif
+		struct sigaction sa = {};
+		sa.sa_handler = print_backtrace;
+		sa.sa_flags = SA_RESTART;
+		sigaction(SIGUSR2, &sa, nullptr);
+	}
+
+	static void print_timeout(const test_case* t, unsigned long long limit) {
+		char buf[512];
+		fprintf(stderr, "\x1B[1m%s:%u: %s: \x1B[31merror:\x1B[0m timed out after %.3fms\n", t->info->file, t->info->line, describe(t, buf, sizeof buf), limit / 1e6);
+	}
+
+	static int summary();
+
+	static void* watchdog(void*) {
+		while (!__atomic_load_n(&watchdog_stop, __ATOMIC_ACQUIRE)) {
+			timespec ts{0, 10000000};
+			nanosleep(&ts, nullptr);
+			for (unsigned i = 0; i < watch_count; ++i) {
+				watch& w = watches[i];
+				test_case* t = __atomic_load_n(&w.test, __ATOMIC_ACQUIRE);
+				unsigned long long start = __atomic_load_n(&w.start, __ATOMIC_RELAXED), limit = __atomic_load_n(&w.limit, __ATOMIC_RELAXED);
+				__atomic_thread_fence(__ATOMIC_ACQUIRE);
+				if (!t || t != __atomic_load_n(&w.test, __ATOMIC_RELAXED) || !limit || now() - start <= limit) continue;  // Or the next test started.
+
+				if (!__atomic_load_n(&w.cancelled, __ATOMIC_RELAXED)) {
+					print_timeout(t, limit);
+					__atomic_store_n(&w.cancelled, true, __ATOMIC_RELEASE);
+					pthread_kill(w.thread, SIGUSR2);
+				} else if (now() - start > 2 * limit) {
+					char buf[512];
+					fprintf(stderr, "\x1B[1m%s: \x1B[31merror:\x1B[0m did not return after it was cancelled, giving up\n", describe(t, buf, sizeof buf));
+					failure f{nullptr, 0, "exceeded TDD_TIMEOUT_MS"};
+					t->ns = now() - start;
+					report(t, "timeout", &f, 1);
+					__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+					summary();
+					exit(timeout_status);
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	static void start_watchdog() {
+		pthread_mutex_lock(&watchdog_lock);
+		if (!watchdog_running) {
+			catch_backtrace_signal();
+			watchdog_stop = false;
+			if (pthread_create(&watchdog_thread, nullptr, watchdog, nullptr)) { perror("tdd"); exit(1); }
+			watchdog_running = true;
+		}
+		pthread_mutex_unlock(&watchdog_lock);
+	}
+
+	static void stop_watchdog() {
+		if (!watchdog_running) return;
+		__atomic_store_n(&watchdog_stop, true, __ATOMIC_RELEASE);
+		pthread_join(watchdog_thread, nullptr);
+		watchdog_running = false;
+	}
+	// }}}
+
+	// concurrent {{{
+	// A CONCURRENT_TEST runs its body on threads of its own, pinned to the first cores this process may use if there are
+	// enough, and released together from a spin barrier. Only one runs at a time, also with TDD_JOBS.
+	thread_local constinit unsigned thread_index = 0;
+	thread_local constinit unsigned long long thread_ops = 0;
+
+	struct race {
+		test_case* test;
+		watch* runner;     // Of the thread that runs the test, for tdd::cancelled().
+		unsigned waiting;  // Threads not at the barrier yet.
+		bool yield;        // More threads than cores.
+	};
+
+	struct racer {
+		pthread_t thread;
+		unsigned index;
+		race* shared;
+		unsigned long long ns, ops;
+		failure failures[max_failures];
+		unsigned failure_count;
+	};
+
+	static pthread_mutex_t race_lock = PTHREAD_MUTEX_INITIALIZER;
+
+	static void* run_racer(void* p) {
+		racer& r = *(racer*)p;
+		thread_index = r.index;
+		current_watch = r.shared->runner;
+		log_begin(r.shared->test);
+		__atomic_sub_fetch(&r.shared->waiting, 1, __ATOMIC_ACQ_REL);
+		while (__atomic_load_n(&r.shared->waiting, __ATOMIC_ACQUIRE)) {
+			if (r.shared->yield) sched_yield();
+		#if defined(__x86_64__) || defined(__i386__)
+			else __builtin_ia32_pause();
+		#endif
+		}
+		unsigned long long start = now();
+		r.shared->test->call();
+		r.ns = now() - start;
+		r.ops = thread_ops;
+		r.failure_count = failure_count;
+		memcpy(r.failures, failures, sizeof failures);
+		log_end(!log_quiet || failure_count);
+		return nullptr;
+	}
+
+	// Runs t on n threads and appends its operations per second to extra.
+	static void race_on(test_case* t, unsigned n, const int* cpus, unsigned cores, record& extra) {
+		racer* racers = (racer*)calloc(n, sizeof(racer));
+		if (!racers) { perror("tdd"); exit(1); }
+		race r{t, current_watch, n, n > cores};
+
+		for (unsigned i = 0; i < n; ++i) {
+			pthread_attr_t attr;
+			pthread_attr_init(&attr);
+			if (i < cores) {
+				cpu_set_t cpu;
+				CPU_ZERO(&cpu);
+				CPU_SET(cpus[i], &cpu);
+				pthread_attr_setaffinity_np(&attr, sizeof cpu, &cpu);
+			}
+			racers[i].index = i;
+			racers[i].shared = &r;
+			if (pthread_create(&racers[i].thread, &attr, run_racer, &racers[i])) { perror("tdd"); exit(1); }
+			pthread_attr_destroy(&attr);
+		}
+
+		unsigned long long ops = 0, wall = 0;
+		double min = 1e300, max = 0;
+		for (unsigned i = 0; i < n; ++i) {
+			racer& x = racers[i];
+			pthread_join(x.thread, nullptr);
+			unsigned kept = x.failure_count < max_failures ? x.failure_count : max_failures;
+			for (unsigned k = 0; k < kept; ++k) record_failure(x.failures[k]);
+			failure_count += x.failure_count - kept;
+
+			double rate = x.ns ? x.ops * 1e9 / x.ns : 0;
+			if (rate < min) min = rate;
+			if (rate > max) max = rate;
+			ops += x.ops;
+			if (x.ns > wall) wall = x.ns;
+		}
+		free(racers);
+		if (!ops) return;
+
+		char buf[512];
+		double total = wall ? ops * 1e9 / wall : 0;
+		fprintf(text_out(), "%-32s %3u threads %14.0f ops/s  per thread %14.0f  min %14.0f  max %14.0f\n", describe(t, buf, sizeof buf), n, total, total / n, min, max);
+		extra.addf("%s{\"threads\":%u,\"ops_per_s\":%.0f,\"min\":%.0f,\"max\":%.0f}", extra.len ? "," : ",\"runs\":[", n, total, min, max);
+	}
+
+	static void run_concurrent(test_case* t, record& extra) {
+		static int cpus[CPU_SETSIZE];
+		static unsigned cores = 0;
+		cpu_set_t allowed;
+
+		pthread_mutex_lock(&race_lock);
+		if (!cores && !sched_getaffinity(0, sizeof allowed, &allowed))
+			for (int i = 0; i < CPU_SETSIZE; ++i) if (CPU_ISSET(i, &allowed)) cpus[cores++] = i;
+
+		unsigned long long start = now();
+		if (unsigned n = t->info->threads) race_on(t, n, cpus, cores, extra);
+		else for (n = 1;; n *= 2) {  // 1, 2, 4, ..., all cores
+			race_on(t, n < cores ? n : cores ? cores : 1, cpus, cores, extra);
+			if (n >= cores) break;
+		}
+		if (extra.len) extra.addf("]");
+		t->ns = now() - start;
+		pthread_mutex_unlock(&race_lock);
+	}
+	// }}}
+
+	// property {{{
+	// A PROPERTY draws its values from choices. While searching, case i chooses at random, seeded with the seed and i,
+	// on case_threads(), and the first failing case wins, so that the same seed finds the same case. Shrinking replays
+	// it with smaller choices and keeps each one that still fails. The final replay prints what it draws, and reports
+	// its failures like any test.
+	constexpr unsigned max_shrinks = 10000;  // Replays.
+
+	static unsigned long long property_seed;
+	static unsigned property_cases;
+	static unsigned jobs;  // Of the pool, set by run_threads().
+
+	// Threads to spread the cases of one test over: TDD_JOBS, capped by the cases, or only the caller's while the
+	// pool already keeps the cores busy.
+	static unsigned case_threads(unsigned long long cases) {
+		unsigned n = jobs > 1 ? 1 : env_count("TDD_JOBS", TDD_JOBS, true);
+		if (n > cases) n = cases ? (unsigned)cases : 1;
+		return n;
+	}
+
+	struct search {
+		test_case* test;
+		watch* runner;
+		unsigned threads, started;
+		unsigned found;  // Lowest failing case so far, or property_cases.
+	};
+
+	static unsigned long long case_seed(unsigned i) {
+		unsigned long long s = property_seed + i * 0xD1B54A32D192ED03ull;
+		return next_random(s);
+	}
+
+	static bool run_case(test_case* t, unsigned long long rng, const unsigned long long* replay, unsigned replay_n) {
+		choices& c = current_choices;
+		c.n = 0;
+		c.rng = rng;
+		c.replay = replay;
+		c.replay_n = replay_n;
+		c.failed = false;
+		t->call();
+		return c.failed;
+	}
+
+	static void* search_cases(void* p) {
+		search& s = *(search*)p;
+		choices& c = current_choices;
+		current_watch = s.runner;
+		bool helper = !ring.test;  // Or the runner, which logs already.
+		if (helper) log_begin(s.test);
+		c.active = c.probing = true;
+		for (unsigned i = __atomic_fetch_add(&s.started, 1, __ATOMIC_RELAXED); i < __atomic_load_n(&s.found, __ATOMIC_RELAXED) && !::tdd::cancelled(); i += s.threads)
+			if (run_case(s.test, case_seed(i), nullptr, 0))
+				for (unsigned f = __atomic_load_n(&s.found, __ATOMIC_RELAXED); i < f;)
+					if (__atomic_compare_exchange_n(&s.found, &f, i, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+		c.active = c.probing = false;
+		if (helper) log_end(!log_quiet);
+		return nullptr;
+	}
+
+	static void run_property(test_case* t) {
+		unsigned threads = case_threads(property_cases);
+		search s{t, current_watch, threads, 0, property_cases};
+		pthread_t* helpers = (pthread_t*)malloc(threads * sizeof(pthread_t));
+		if (!helpers) { perror("tdd"); exit(1); }
+		for (unsigned i = 1; i < threads; ++i)
+			if (pthread_create(&helpers[i], nullptr, search_cases, &s)) { perror("tdd"); exit(1); }
+		search_cases(&s);
+		for (unsigned i = 1; i < threads; ++i) pthread_join(helpers[i], nullptr);
+		free(helpers);
+		if (s.found == property_cases) return;
+
+		choices& c = current_choices;
+		c.active = c.probing = true;
+		run_case(t, case_seed(s.found), nullptr, 0);
+		unsigned long long* best = (unsigned long long*)malloc((c.n ? c.n : 1) * sizeof *best);
+		if (!best) { perror("tdd"); exit(1); }
+		unsigned n = c.n, tries = 0, shrinks = 0;
+		memcpy(best, c.v, n * sizeof *best);
+
+		for (bool smaller = true; smaller && tries < max_shrinks;) {
+			smaller = false;
+			for (unsigned i = 0; i < n && tries < max_shrinks; ++i)
+				for (unsigned long long lo = 0, hi = best[i]; lo < hi && tries < max_shrinks; ++tries) {  // hi fails.
+					unsigned long long mid = lo + (hi - lo) / 2, old = best[i];
+					best[i] = mid;
+					if (!run_case(t, 0, best, n)) { best[i] = old; lo = mid + 1; continue; }
+					if (c.n > n && !(best = (unsigned long long*)realloc(best, c.n * sizeof *best))) { perror("tdd"); exit(1); }
+					memcpy(best, c.v, c.n * sizeof *best);  // What it chose, which may be fewer.
+					n = c.n;
+					++shrinks;
+					smaller = true;
+					if (i >= n) break;
+					hi = best[i];
+				}
+		}
+
+		char buf[512];
+		print("\x1B[1m%s:%u: %s: \x1B[31merror:\x1B[0m case %u of %u failed, shrunk %u times, TDD_SEED=%llu repeats it\n",
+		      t->info->file, t->info->line, describe(t, buf, sizeof buf), s.found + 1, property_cases, shrinks, property_seed);
+		c.probing = false;
+		showing = true;
+		unsigned before = failure_count;
+		run_case(t, 0, best, n);
+		showing = c.active = false;
+		if (failure_count == before) {  // Flaky.
+			record_failure({nullptr, 0, "failed, but not when replayed"});
+			__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+		}
+		free(best);
+	}
+	// }}}
+
+	// sweep {{{
+	// A test with rseq<>s runs once per combination of their values, on case_threads(), which take chunks of them in
+	// order. Failures are quiet, like while a PROPERTY searches; afterwards the lowest failing combination runs again,
+	// prints its values, and reports its failures like any test.
+	struct sweep {
+		test_case* test;
+		watch* runner;
+		unsigned long long chunk;
+		unsigned long long next;   // First combination no thread took.
+		unsigned long long found;  // Lowest failing one so far, or test->values.
+	};
+
+	static void* sweep_values(void* p) {
+		sweep& s = *(sweep*)p;
+		choices& c = current_choices;
+		current_watch = s.runner;
+		bool helper = !ring.test;  // Or the runner, which logs already.
+		if (helper) log_begin(s.test);
+		c.probing = true;
+		for (unsigned long long i; (i = __atomic_fetch_add(&s.next, s.chunk, __ATOMIC_RELAXED)) < __atomic_load_n(&s.found, __ATOMIC_RELAXED);) {
+			unsigned long long end = i + s.chunk < s.test->values ? i + s.chunk : s.test->values;
+			for (; i < end && !::tdd::cancelled(); ++i) {
+				s.test->at(i, false);
+				c.failed = false;
+				s.test->call();
+				if (!c.failed) continue;
+				for (unsigned long long f = __atomic_load_n(&s.found, __ATOMIC_RELAXED); i < f;)
+					if (__atomic_compare_exchange_n(&s.found, &f, i, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+				break;  // The rest of the chunk is higher.
+			}
+			if (::tdd::cancelled()) break;
+		}
+		c.probing = false;
+		if (helper) log_end(!log_quiet);
+		return nullptr;
+	}
+
+	static void run_sweep(test_case* t) {
+		unsigned threads = case_threads(t->values);
+		sweep s{t, current_watch, t->values / (threads * 64ull) + 1, 0, t->values};  // About 64 chunks per thread.
+		pthread_t* helpers = (pthread_t*)malloc(threads * sizeof(pthread_t));
+		if (!helpers) { perror("tdd"); exit(1); }
+		for (unsigned i = 1; i < threads; ++i)
+			if (pthread_create(&helpers[i], nullptr, sweep_values, &s)) { perror("tdd"); exit(1); }
+		sweep_values(&s);
+		for (unsigned i = 1; i < threads; ++i) pthread_join(helpers[i], nullptr);
+		free(helpers);
+		if (s.found == t->values) return;
+
+		char buf[512];
+		print("\x1B[1m%s:%u: %s: \x1B[31merror:\x1B[0m failed at combination %llu of %llu\n",
+		      t->info->file, t->info->line, describe(t, buf, sizeof buf), s.found + 1, t->values);
+		t->at(s.found, true);
+		unsigned before = failure_count;
+		t->call();
+		if (failure_count == before) {  // Flaky.
+			record_failure({nullptr, 0, "failed, but not when run again"});
+			__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+		}
+	}
+	// }}}
+
+	// perf {{{
+	// Every runner thread opens one group of the events that the first probe could open, and reads it around each test.
+	struct perf_event {
+		const char* name;
+		unsigned type;
+		unsigned long long config;
+	};
+
+	constexpr unsigned max_events = 6;
+	static perf_event events[max_events];
+	static unsigned event_count = 0;  // 0 without TDD_PERF.
+
+	struct perf_group {
+		int fds[max_events];
+		bool opened;
+	};
+
+	static thread_local perf_group group;
+
+	#if __has_include(<linux/perf_event.h>)
+	static int perf_open(const perf_event& e, int leader) {
+		perf_event_attr a{};
+		a.size = sizeof a;
+		a.type = e.type;
+		a.config = e.config;
+		a.exclude_kernel = a.exclude_hv = 1;  // Allowed without privileges.
+		a.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return (int)syscall(SYS_perf_event_open, &a, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+	}
+
+	static void perf_probe() {
+		constexpr unsigned long long l1d_miss = PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+		constexpr unsigned long long llc_miss = PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+		const perf_event hardware[] = {
+			{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+			{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+			{"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+			{"L1D-misses", PERF_TYPE_HW_CACHE, l1d_miss},
+			{"LLC-misses", PERF_TYPE_HW_CACHE, llc_miss},
+			{"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+		};
+		const perf_event software[] = {  // In VMs and containers without a PMU.
+			{"task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+			{"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+		};
+		for (const perf_event& e : hardware)
+			if (int fd = perf_open(e, -1); fd >= 0) { close(fd); events[event_count++] = e; }
+		if (event_count && events[0].type != PERF_TYPE_SOFTWARE) return;
+
+		event_count = 0;
+		for (const perf_event& e : software)
+			if (int fd = perf_open(e, -1); fd >= 0) { close(fd); events[event_count++] = e; }
+		if (!event_count) fprintf(stderr, "tdd: TDD_PERF: perf_event_open failed, see /proc/sys/kernel/perf_event_paranoid\n");
+	}
+
+	// Counts since the group was opened, scaled up if the kernel had to multiplex them.
+	static void perf_read(unsigned long long* v) {
+		perf_group& g = group;
+		if (!g.opened) {
+			g.opened = true;
+			for (unsigned i = 0; i < event_count; ++i) g.fds[i] = perf_open(events[i], i ? g.fds[0] : -1);
+		}
+		unsigned long long buf[3 + max_events] = {};
+		if (g.fds[0] < 0 || read(g.fds[0], buf, sizeof buf) <= 0) buf[0] = 0;
+		double scale = buf[2] && buf[2] < buf[1] ? (double)buf[1] / buf[2] : 1;
+		for (unsigned i = 0, k = 0; i < event_count; ++i)  // Events that did not join the group read as 0.
+			v[i] = g.fds[i] >= 0 && k < buf[0] ? (unsigned long long)(buf[3 + k++] * scale) : 0;
+	}
+	#else
+	static void perf_probe() { fprintf(stderr, "tdd: TDD_PERF needs Linux\n"); }
+	static void perf_read(unsigned long long* v) { for (unsigned i = 0; i < event_count; ++i) v[i] = 0; }
+	#endif
+
+	// In a forked worker, whose inherited descriptors count the parent.
+	static void perf_forget() { group.opened = false; }
+
+	static void perf_json(record& r, const unsigned long long* v, double ops = 0) {  // Per op for benchmarks.
+		for (unsigned i = 0; i < event_count; ++i) {
+			r.addf("%s\"%s\":", i ? "," : ",\"perf\":{", events[i].name);
+			if (ops) r.addf("%.3f", v[i] / ops);
+			else     r.addf("%llu", v[i]);
+		}
+		if (event_count) r.addf("}");  // Keeps the record terminated.
+	}
+	// }}}
+
+	// fixtures {{{
+	// All instances of all fixtures in one pool. A runtime test holds at most one of each until it ends, which all its
+	// threads find by its watch; benchmarks, which run one at a time outside of any, hold theirs by outside.
+	struct pooled {
+		const fixture_type* type;
+		const test_info* family;  // nullptr for per::binary.
+		const void* holder;       // nullptr while free.
+		void* object;
+		bool ready;               // Made, or reset, for its holder.
+		bool used;                // By an earlier test.
+		pooled* next;
+	};
+
+	static pooled* pool = nullptr;
+	static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+	static unsigned long long pool_epoch = 0;  // Changes whenever a holder lets go.
+	static const test_case* benchmark = nullptr;  // Running.
+	static const char outside = 0;
+
+	struct last_taken {  // Per thread, so that taking the same fixture again in a loop skips the lock.
+		const fixture_type* type;
+		const void* holder;
+		unsigned long long epoch;
+		void* object;
+	};
+	static thread_local last_taken last_take;
+
+	void* take(const fixture_type& f) noexcept {
+		watch* w = current_watch;
+		const test_case* t = w ? __atomic_load_n(&w->test, __ATOMIC_ACQUIRE) : nullptr;
+		const void* holder = t ? (const void*)w : &outside;
+		if (!t) t = benchmark;
+		const test_info* family = f.scope == per::binary || !t ? nullptr : t->info;
+		last_taken& l = last_take;
+		unsigned long long epoch = __atomic_load_n(&pool_epoch, __ATOMIC_ACQUIRE);
+		if (l.type == &f && l.holder == holder && l.epoch == epoch) return l.object;
+
+		pthread_mutex_lock(&pool_lock);
+		pooled* p = pool;
+		for (; p && !(p->type == &f && p->holder == holder); p = p->next) {}
+		if (p) {  // Another thread of the test may still be making or resetting it.
+			pthread_mutex_unlock(&pool_lock);
+			while (!__atomic_load_n(&p->ready, __ATOMIC_ACQUIRE)) sched_yield();
+			l = {&f, holder, epoch, p->object};
+			return p->object;
+		}
+		for (p = pool; p && !(p->type == &f && !p->holder && p->family == family); p = p->next) {}
+		if (p) p->holder = holder;
+		else {
+			if (!(p = (pooled*)malloc(sizeof(pooled)))) { perror("tdd"); exit(1); }
+			*p = {&f, family, holder, nullptr, false, false, pool};
+			pool = p;
+		}
+		__atomic_store_n(&p->ready, false, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&pool_lock);
+
+		if (!p->object) p->object = f.make();
+		else if (p->used && f.reset) f.reset(p->object);
+		__atomic_store_n(&p->ready, true, __ATOMIC_RELEASE);
+		l = {&f, holder, epoch, p->object};
+		return p->object;
+	}
+
+	static void destroy_fixtures(pooled* gone) {
+		for (pooled* next; gone; gone = next) {
+			next = gone->next;
+			gone->type->destroy(gone->object);
+			free(gone);
+		}
+	}
+
+	// Returns what the holder took when test t ends, and destroys what no later test can use.
+	static void release_fixtures(const void* holder, const test_info* t) {
+		bool last = !__atomic_sub_fetch(&t->left, 1, __ATOMIC_RELAXED);
+		if (!__atomic_load_n(&pool, __ATOMIC_RELAXED)) return;
+		pooled* gone = nullptr;
+		pthread_mutex_lock(&pool_lock);
+		for (pooled** p = &pool; *p;) {
+			pooled* f = *p;
+			if (f->holder == holder) {
+				__atomic_add_fetch(&pool_epoch, 1, __ATOMIC_RELEASE);
+				f->holder = nullptr;
+				f->used = true;
+			}
+			if (!f->holder && (f->type->scope == per::test || (last && f->family == t))) {
+				*p = f->next;
+				f->next = gone;
+				gone = f;
+			}
+			else p = &f->next;
+		}
+		pthread_mutex_unlock(&pool_lock);
+		destroy_fixtures(gone);
+	}
+
+	static void close_fixtures() {
+		destroy_fixtures(pool);
+		pool = nullptr;
+	}
+	// }}}
+
+	static unsigned long long budget;  // ns, 0 for none.
+
+	static void run_one(test_case* t) {
+		watch& w = *current_watch;
+		failure_count = 0;
+		__atomic_store_n(&w.cancelled, false, __ATOMIC_RELAXED);
+		__atomic_store_n(&w.limit, default_timeout, __ATOMIC_RELAXED);
+		__atomic_store_n(&w.start, now(), __ATOMIC_RELAXED);
+		__atomic_store_n(&w.test, t, __ATOMIC_RELEASE);
+		log_begin(t);
+		static thread_local record extra;
+		extra.len = 0;
+		unsigned long long perf_start[max_events];
+		if (event_count) perf_read(perf_start);
+		alloc_counts before = allocs;
+		allocs.peak = allocs.live;
+		if (t->info->cat == category::MT) run_concurrent(t, extra);
+		else if (t->info->cat == category::P) {
+			unsigned long long start = now();
+			run_property(t);
+			t->ns = now() - start;
+		}
+		else if (t->values) {
+			unsigned long long start = now();
+			run_sweep(t);
+			t->ns = now() - start;
+		}
+		else timed_call(t);
+		release_fixtures(&w, t->info);
+		__atomic_store_n(&w.test, nullptr, __ATOMIC_RELEASE);
+		if (event_count) {
+			perf_read(t->perf);
+			for (unsigned i = 0; i < event_count; ++i) t->perf[i] -= perf_start[i];
+		}
+		t->allocs = allocs.count - before.count;  // Of this thread only.
+		t->alloc_bytes = allocs.bytes - before.bytes;
+		t->peak_bytes = allocs.peak > before.live ? allocs.peak - before.live : 0;
+		if (TDD_ALLOCS)
+			extra.addf(",\"allocs\":%llu,\"alloc_bytes\":%llu,\"peak_bytes\":%llu", t->allocs, t->alloc_bytes, t->peak_bytes);
+		if (event_count) perf_json(extra, t->perf);
+		bool timeout = __atomic_load_n(&w.cancelled, __ATOMIC_ACQUIRE);
+		if (timeout) {
+			record_failure({nullptr, 0, "exceeded TDD_TIMEOUT_MS"});
+			__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+		}
+		if (budget && t->ns > budget) {
+			char buf[512];
+			print("\x1B[1m%s: \x1B[31merror:\x1B[0m took %.3fms, budget is %.3fms\n", describe(t, buf, sizeof buf), t->ns / 1e6, budget / 1e6);
+			record_failure({nullptr, 0, "exceeded TDD_BUDGET_MS"});
+			__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+		}
+		log_end(!log_quiet || failure_count);
+		report(t, timeout ? "timeout" : failure_count ? "failed" : "passed", failures, failure_count, extra.len ? extra.data : "");
+	}
+
+	static test_info*  first_info = nullptr;
+	static test_info** last_info  = &first_info;
+	static test_case*  first = nullptr;
+	static test_case** last  = &first;
+
+	// Called during static initialization, in declaration order.
+	void enlist(test_info* t) noexcept {
+		if (t->next || last_info == &t->next) return;
+		*last_info = t;
+		last_info = &t->next;
+	}
+
+	void enlist(test_case* t) noexcept {
+		if (t->next || last == &t->next) return;
+		*last = t;
+		last = &t->next;
+	}
+
+	// pool {{{
+	// Work stealing over the array of runtime tests. Each worker owns a range [lo, hi) packed in one word, takes tests
+	// from the front of its own range, and when it runs dry, steals the back half of another worker's range.
+	// Ranges only ever shrink or get replaced with indices no one has taken, so a plain CAS is free of ABA.
+	struct worker {
+		alignas(64) unsigned long long range;
+		pthread_t thread;
+	};
+
+	static test_case** cases;
+	static worker* workers;
+
+	static unsigned long long pack(unsigned lo, unsigned hi) { return (unsigned long long)hi << 32 | lo; }
+	static unsigned lo_of(unsigned long long r) { return (unsigned)r; }
+	static unsigned hi_of(unsigned long long r) { return (unsigned)(r >> 32); }
+
+	static bool take(worker& w, unsigned& index) {
+		unsigned long long r = __atomic_load_n(&w.range, __ATOMIC_ACQUIRE);
+		while (lo_of(r) < hi_of(r))
+			if (__atomic_compare_exchange_n(&w.range, &r, pack(lo_of(r) + 1, hi_of(r)), true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				index = lo_of(r);
+				return true;
+			}
+		return false;
+	}
+
+	static bool steal(unsigned self) {
+		for (unsigned i = 1; i < jobs; ++i) {
+			worker& victim = workers[(self + i) % jobs];
+			unsigned long long r = __atomic_load_n(&victim.range, __ATOMIC_ACQUIRE);
+			while (lo_of(r) < hi_of(r)) {
+				unsigned mid = hi_of(r) - (hi_of(r) - lo_of(r) + 1) / 2;
+				if (__atomic_compare_exchange_n(&victim.range, &r, pack(lo_of(r), mid), true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+					__atomic_store_n(&workers[self].range, pack(mid, hi_of(r)), __ATOMIC_RELEASE);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	static void* work(void* self) {
+		unsigned id = (unsigned)(unsigned long)self, index;
+		watches[id].thread = pthread_self();
+		current_watch = &watches[id];
+		do {
+			while (take(workers[id], index)) {
+				run_one(cases[index]);
+				tally(counts.completed);
+			}
+		} while (steal(id));
+		return nullptr;
+	}
+	// }}}
+
+	// fork {{{
+	// Worker w runs every forks'th test, starting with the w'th, and reports each start and end through its pipe.
+	// If it dies during a test, that test counts as failed and a new worker continues with the next one.
+	struct message {
+		unsigned index;
+		unsigned errors;        // Errors during the test. ~0u means the test started, ~1u that ns is its new timeout.
+		unsigned long long ns;
+		unsigned long long passed, failed;  // Assertions during the test.
+		unsigned long long allocs = 0, alloc_bytes = 0, peak_bytes = 0;
+		unsigned long long perf[max_events] = {};
+	};
+
+	struct process {
+		pid_t pid;
+		int fd;
+		long running;           // Index of the test being run, or -1.
+		unsigned long long start, limit;
+		bool timed_out;         // Killed by the parent.
+	};
+
+	static int worker_fd = -1;  // In a worker process, the pipe to the parent.
+	static unsigned worker_test, worker_errors;  // The test it runs, and its errors before it.
+	static unsigned long long worker_start;
+	static counters worker_counts;
+
+	static void send(int fd, message m) {
+		if (write(fd, &m, sizeof m) != sizeof m) _exit(1);
+	}
+
+	static void send_result() {
+		counters d = totals();
+		test_case* t = cases[worker_test];
+		message m{worker_test, errors - worker_errors, t->ns, d.passed - worker_counts.passed, d.failed - worker_counts.failed,
+		          t->allocs, t->alloc_bytes, t->peak_bytes, {}};
+		if (t->perf) memcpy(m.perf, t->perf, sizeof m.perf);
+		send(worker_fd, m);
+	}
+
+	// At TDD_MAX_ERRORS in a worker: the parent counts the test like any other, and stops at the same cap.
+	static void stop_worker() {
+		if (worker_fd < 0) return;
+		cases[worker_test]->ns = now() - worker_start;
+		send_result();
+		fflush(nullptr);
+		_exit(0);
+	}
+
+	[[noreturn]] static void worker_process(unsigned index, unsigned forks, unsigned count, int fd) {
+		watch w{};
+		current_watch = &w;
+		worker_fd = fd;
+		perf_forget();
+		for (unsigned i = 0; i < count; ++i) cases[i]->info->left = 0;  // Only what this worker runs, so that per::family
+		for (unsigned i = index; i < count; i += forks) ++cases[i]->info->left;  // fixtures go after its last one.
+		for (; index < count; index += forks) {
+			send(fd, {index, ~0u, 0, 0, 0});
+			worker_test = index;
+			worker_errors = errors;
+			worker_counts = totals();
+			worker_start = now();
+			run_one(cases[index]);
+			send_result();
+		}
+		close_fixtures();  // And the per::binary ones, which _exit() would skip.
+		fflush(nullptr);
+		_exit(0);
+	}
+
+	static void spawn(process& p, unsigned index, unsigned forks, unsigned count) {
+		int fds[2];
+		fflush(nullptr);
+		report_flush();
+		if (pipe(fds) || (p.pid = fork()) < 0) { perror("tdd"); exit(1); }
+		if (p.pid == 0) {
+			close(fds[0]);
+			report_sync = true;
+			worker_process(index, forks, count, fds[1]);
+		}
+		close(fds[1]);
+		p.fd = fds[0];
+		p.running = -1;
+		p.timed_out = false;
+	}
+
+	// Before the parent exits, so that no record of theirs comes after the end of the report.
+	static void stop_workers(process* procs, unsigned forks) {
+		for (unsigned k = 0; k < forks; ++k)
+			if (procs[k].fd >= 0) { kill(procs[k].pid, SIGKILL); waitpid(procs[k].pid, nullptr, 0); }
+	}
+
+	static void run_forked(unsigned count, unsigned forks) {
+		if (forks > count) forks = count;
+		process* procs = (process*)malloc(forks * sizeof(process));
+		pollfd* fds = (pollfd*)malloc(forks * sizeof(pollfd));
+		if (!procs || !fds) { perror("tdd"); exit(1); }
+
+		catch_backtrace_signal();  // Inherited by the workers.
+		for (unsigned i = 0; i < forks; ++i) spawn(procs[i], i, forks, count);
+
+		for (unsigned alive = forks; alive;) {
+			int wait = -1;  // ms until the next timeout
+			unsigned long long t = now();
+			for (unsigned i = 0; i < forks; ++i) {
+				process& p = procs[i];
+				fds[i] = {p.fd, POLLIN, 0};
+				if (p.fd < 0 || p.running < 0 || !p.limit || p.timed_out) continue;
+				int left = p.start + p.limit > t ? (int)((p.start + p.limit - t) / 1000000 + 1) : 0;
+				if (wait < 0 || left < wait) wait = left;
+			}
+			if (poll(fds, forks, wait) < 0) continue;
+
+			for (unsigned i = 0; i < forks; ++i) {  // The backtrace, then the worker is killed and the run continues.
+				process& p = procs[i];
+				if (p.fd < 0 || p.running < 0 || !p.limit || p.timed_out || now() - p.start <= p.limit) continue;
+				print_timeout(cases[p.running], p.limit);
+				kill(p.pid, SIGUSR2);
+				timespec ts{0, 100000000};
+				nanosleep(&ts, nullptr);
+				kill(p.pid, SIGKILL);
+				p.timed_out = true;
+			}
+
+			for (unsigned i = 0; i < forks; ++i) {
+				process& p = procs[i];
+				if (p.fd < 0 || !fds[i].revents) continue;
+
+				message msgs[64];  // Messages are smaller than PIPE_BUF, so a read never splits one.
+				ssize_t n = read(p.fd, msgs, sizeof msgs);
+				for (ssize_t m = 0; m < n / (ssize_t)sizeof(message); ++m) {
+					if (msgs[m].errors == ~0u) { p.running = msgs[m].index; p.start = now(); p.limit = default_timeout; continue; }
+					if (msgs[m].errors == ~1u) { p.limit = msgs[m].ns; continue; }
+					p.running = -1;
+					test_case* t = cases[msgs[m].index];
+					t->ns = msgs[m].ns;
+					t->allocs = msgs[m].allocs;
+					t->alloc_bytes = msgs[m].alloc_bytes;
+					t->peak_bytes = msgs[m].peak_bytes;
+					if (t->perf) memcpy(t->perf, msgs[m].perf, sizeof msgs[m].perf);
+					tally(counts.completed);
+					tally(counts.passed, msgs[m].passed);
+					tally(counts.failed, msgs[m].failed);
+					if (msgs[m].errors && (errors += msgs[m].errors) >= TDD_MAX_ERRORS) {
+						stop_workers(procs, forks);
+						exit(errors);
+					}
+				}
+				if (n > 0) continue;
+
+				int status;  // Worker is done, or died.
+				close(p.fd);
+				p.fd = -1;
+				waitpid(p.pid, &status, 0);
+				if (p.running < 0) { --alive; continue; }
+
+				test_case* t = cases[p.running];
+				char buf[512], why[128];
+				t->ns = now() - p.start;
+				if (p.timed_out) snprintf(why, sizeof why, "exceeded TDD_TIMEOUT_MS");  // Printed already.
+				else {
+					if (WIFSIGNALED(status)) snprintf(why, sizeof why, "crashed with signal %d (%s)", WTERMSIG(status), strsignal(WTERMSIG(status)));
+					else                     snprintf(why, sizeof why, "exited with status %d", WEXITSTATUS(status));
+					fprintf(stderr, "\x1B[1m%s: \x1B[31merror:\x1B[0m %s\n", describe(t, buf, sizeof buf), why);
+				}
+				failure f{nullptr, 0, why};
+				report(t, p.timed_out ? "timeout" : "crashed", &f, 1);
+				tally(counts.completed);
+				if (++errors >= TDD_MAX_ERRORS) {
+					stop_workers(procs, forks);
+					exit(errors);
+				}
+
+				if (p.running + forks < count) spawn(p, p.running + forks, forks, count);
+				else --alive;
+			}
+		}
+		free(procs);
+		free(fds);
+	}
+	// }}}
+
+	void set_timeout(unsigned ms) noexcept {
+		watch* w = current_watch;
+		if (!w || !w->test) return;  // Not in a runtime test.
+		__atomic_store_n(&w->limit, ms * 1000000ull, __ATOMIC_RELAXED);
+		if (worker_fd >= 0) send(worker_fd, {0, ~1u, ms * 1000000ull, 0, 0});
+		else if (ms) start_watchdog();
+	}
+
+	static void run_pool(unsigned count) {
+		workers = (worker*)aligned_alloc(alignof(worker), jobs * sizeof(worker));
+		if (!workers) { perror("tdd"); exit(1); }
+		for (unsigned i = 0; i < jobs; ++i)
+			workers[i].range = pack(count * (unsigned long long)i / jobs, count * (unsigned long long)(i + 1) / jobs);
+
+		for (unsigned i = 1; i < jobs; ++i)
+			if (pthread_create(&workers[i].thread, nullptr, work, (void*)(unsigned long)i)) { perror("tdd"); exit(1); }
+		work(nullptr);
+		for (unsigned i = 1; i < jobs; ++i) pthread_join(workers[i].thread, nullptr);
+		free(workers);
+	}
+
+	static void run_threads(unsigned count) {
+		jobs = env_count("TDD_JOBS", TDD_JOBS, true);
+		if (jobs > count) jobs = count;
+		if (jobs < 1) jobs = 1;
+		watch_count = jobs;
+		watches = (watch*)calloc(jobs, sizeof(watch));
+		if (!watches) { perror("tdd"); exit(1); }
+		if (default_timeout) start_watchdog();
+
+		if (jobs > 1) run_pool(count);
+		else {  // Declaration order.
+			watches[0].thread = pthread_self();
+			current_watch = &watches[0];
+			for (unsigned i = 0; i < count; ++i) { run_one(cases[i]); tally(counts.completed); }
+		}
+
+		stop_watchdog();
+		current_watch = nullptr;
+		free(watches);
+		watches = nullptr;
+	}
+
+	static void report_times(unsigned count) {
+		unsigned long long total = 0;
+		char buf[512];
+		unsigned top = env_count("TDD_SLOWEST", TDD_SLOWEST, false), listed = 0;
+		if (top > count) top = count;
+		test_case** slowest = (test_case**)malloc((top ? top : 1) * sizeof(test_case*));
+		if (!slowest) { perror("tdd"); exit(1); }
+
+		for (unsigned i = 0; i < count; ++i) {
+			test_case* t = cases[i];
+			total += t->ns;
+			if (!top || (listed == top && slowest[top - 1]->ns >= t->ns)) continue;
+
+			unsigned k = listed < top ? listed++ : top - 1;  // Insertion into the sorted list.
+			for (; k && slowest[k - 1]->ns < t->ns; --k) slowest[k] = slowest[k - 1];
+			slowest[k] = t;
+		}
+
+		if (top) {
+			fprintf(stderr, "slowest tests:\n");
+			for (unsigned i = 0; i < listed; ++i) fprintf(stderr, "%12.3fms  %s\n", slowest[i]->ns / 1e6, describe(slowest[i], buf, sizeof buf));
+			fprintf(stderr, "%12.3fms  total\n", total / 1e6);
+		}
+		free(slowest);
+	}
+
+	static void report_allocs(unsigned count) {
+		char buf[512];
+		bool any = false;
+		for (unsigned i = 0; i < count; ++i) {
+			test_case* t = cases[i];
+			if (!t->allocs) continue;
+			if (!any) fprintf(stderr, "allocations:\n%12s %14s %14s  test\n", "count", "bytes", "peak bytes");
+			any = true;
+			fprintf(stderr, "%12llu %14llu %14llu  %s\n", t->allocs, t->alloc_bytes, t->peak_bytes, describe(t, buf, sizeof buf));
+		}
+	}
+
+	static void report_perf(unsigned count) {
+		char buf[512];
+		fprintf(stderr, "perf counters:\n");
+		for (unsigned i = 0; i < event_count; ++i) fprintf(stderr, "%14s ", events[i].name);
+		fprintf(stderr, " test\n");
+		for (unsigned i = 0; i < count; ++i) {
+			for (unsigned k = 0; k < event_count; ++k) fprintf(stderr, "%14llu ", cases[i]->perf[k]);
+			fprintf(stderr, " %s\n", describe(cases[i], buf, sizeof buf));
+		}
+	}
+
+	// history {{{
+	// An append-only file of fixed size records after a magic number, mapped once per run. Earlier records of a test are
+	// its baseline, and this run's are appended at the end of the run.
+	struct history_record {
+		unsigned long long key;  // Of name<params>.
+		unsigned long long run;  // Start, in ns since the epoch.
+		double ns;               // Of a test, or per op of one benchmark sample.
+	};
+
+	static const char history_magic[8] = {'T', 'D', 'D', 'H', 'I', 'S', 'T', '1'};
+	constexpr unsigned max_baseline = 256;  // Latest samples per test.
+	constexpr double min_compared_ns = 100000;  // Shorter tests are noise.
+	constexpr double significance = 0.01;
+
+	static const char* history_path = "";
+	static const history_record* history = nullptr;
+	static size_t history_count = 0;
+	static size_t* history_order = nullptr;  // Positions, by key and then position.
+	static history_record* fresh = nullptr;  // This run's.
+	static size_t fresh_count = 0, fresh_cap = 0;
+	static unsigned long long run_start;
+	static double regression;
+	static unsigned faster = 0, slower = 0, unchanged = 0;
+
+	static unsigned long long key_of(const test_case* t) {  // FNV-1a
+		const char* params = "";
+		int n = params_of(t, params);
+		unsigned long long h = 14695981039346656037ull;
+		for (const char* p = t->info->name; *p; ++p) h = (h ^ (unsigned char)*p) * 1099511628211ull;
+		h = (h ^ '<') * 1099511628211ull;
+		for (int i = 0; i < n; ++i) h = (h ^ (unsigned char)params[i]) * 1099511628211ull;
+		return h;
+	}
+
+	static int by_key(const void* a, const void* b) {
+		size_t x = *(const size_t*)a, y = *(const size_t*)b;
+		unsigned long long kx = history[x].key, ky = history[y].key;
+		return kx != ky ? (kx < ky ? -1 : 1) : x < y ? -1 : x > y;
+	}
+
+	static void history_open() {
+		const char* env = getenv("TDD_HISTORY");
+		history_path = env ? env : TDD_HISTORY;
+		if (!*history_path) return;
+		const char* percent = getenv("TDD_REGRESSION");
+		regression = (percent ? atof(percent) : TDD_REGRESSION) / 100;
+		timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		run_start = ts.tv_sec * 1000000000ull + ts.tv_nsec;
+
+		int fd = open(history_path, O_RDONLY | O_CLOEXEC);
+		struct stat st;
+		if (fd < 0 || fstat(fd, &st) || (size_t)st.st_size <= sizeof history_magic) { if (fd >= 0) close(fd); return; }
+		void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (m == MAP_FAILED || memcmp(m, history_magic, sizeof history_magic)) {
+			fprintf(stderr, "tdd: %s is not a TDD_HISTORY file\n", history_path);
+			exit(1);
+		}
+		history = (const history_record*)((const char*)m + sizeof history_magic);
+		history_count = (st.st_size - sizeof history_magic) / sizeof(history_record);  // A torn last record is ignored.
+		history_order = (size_t*)malloc((history_count ? history_count : 1) * sizeof(size_t));
+		if (!history_order) { perror("tdd"); exit(1); }
+		for (size_t i = 0; i < history_count; ++i) history_order[i] = i;
+		qsort(history_order, history_count, sizeof(size_t), by_key);
+	}
+
+	// The latest samples of key before this run, oldest first.
+	static unsigned baseline(unsigned long long key, double* out) {
+		size_t lo = 0, hi = history_count;  // First position after the key.
+		while (lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if (history[history_order[mid]].key <= key) lo = mid + 1;
+			else hi = mid;
+		}
+		size_t from = lo;
+		while (from && lo - from < max_baseline && history[history_order[from - 1]].key == key) --from;
+		for (size_t i = from; i < lo; ++i) out[i - from] = history[history_order[i]].ns;
+		return (unsigned)(lo - from);
+	}
+
+	// Probability of samples x at least as much greater than samples y by chance, with the Mann-Whitney U test. Exact for a
+	// single sample, else with the normal approximation. A single sample is at least 1 / (m + 1), so a test is below
+	// significance only after 100 earlier runs.
+	static double mann_whitney(const double* x, unsigned n, const double* y, unsigned m) {
+		double u = 0;
+		for (unsigned i = 0; i < n; ++i)
+			for (unsigned k = 0; k < m; ++k) u += x[i] > y[k] ? 1 : x[i] == y[k] ? 0.5 : 0;
+		if (n == 1) return (m - u + 1) / (m + 1);
+		double mean = n * m / 2.0, sd = sqrt(n * m * (n + m + 1) / 12.0);
+		return 0.5 * erfc((u - mean - 0.5) / sd / sqrt(2.0));
+	}
+
+	// Appends this run's samples and compares them with the baseline.
+	static void history_add(const test_case* t, const double* x, unsigned n) {
+		if (!*history_path) return;
+		unsigned long long key = key_of(t);
+		if (fresh_count + n > fresh_cap) {
+			fresh_cap = 2 * fresh_cap + n;
+			if (!(fresh = (history_record*)realloc(fresh, fresh_cap * sizeof(history_record)))) { perror("tdd"); exit(1); }
+		}
+		for (unsigned i = 0; i < n; ++i) fresh[fresh_count++] = {key, run_start, x[i]};
+
+		double y[max_baseline], current[max_baseline];
+		unsigned m = baseline(key, y);
+		if (n > max_baseline) n = max_baseline;
+		memcpy(current, x, n * sizeof(double));
+		double p = m ? mann_whitney(current, n, y, m) : 1;
+		double before = m ? median(y, m) : 0, after = median(current, n);
+		bool is_test = t->info->cat != category::B;
+		if (!m || (is_test && before < min_compared_ns && after < min_compared_ns)) return;
+
+		double change = before > 0 ? after / before - 1 : 0;
+		if (change > regression) ++slower;
+		else if (change < -regression) ++faster;
+		else ++unchanged;
+		if (change <= regression || p >= significance) return;
+		char buf[512];
+		fprintf(stderr, "\x1B[1m%s:%u: %s: \x1B[31merror:\x1B[0m %.0f%% slower than before, %.6gns instead of %.6gns (p = %.2g)\n",
+		        t->info->file, t->info->line, describe(t, buf, sizeof buf), change * 100, after, before, p);
+		__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+	}
+
+	static void history_close() {
+		if (!*history_path) return;
+		if (faster + slower + unchanged)
+			fprintf(stderr, "than before: %u faster, %u slower, %u within %.0f%%\n", faster, slower, unchanged, regression * 100);
+		int fd = open(history_path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+		struct stat st;
+		bool ok = fd >= 0 && !fstat(fd, &st);
+		if (ok && !st.st_size) ok = write(fd, history_magic, sizeof history_magic) == sizeof history_magic;
+		size_t size = fresh_count * sizeof(history_record);
+		if (!ok || write(fd, fresh, size) != (ssize_t)size) perror("tdd: TDD_HISTORY");
+		if (fd >= 0) close(fd);
+	}
+	// }}}
+
+	// bench {{{
+	static double sample(test_case* b, unsigned long long iterations) {  // ns per iteration
+		bench_iterations = iterations;
+		timed_call(b);
+		return (double)b->ns / iterations;
+	}
+
+	static void run_benchmarks(test_case** benchmarks, unsigned count) {
+		unsigned samples = env_count("TDD_BENCH_SAMPLES", TDD_BENCH_SAMPLES, false);
+		unsigned long long target = TDD_BENCH_SAMPLE_MS * 1000000ull;
+		if (!samples) samples = 1;
+		double* ns = (double*)malloc(samples * sizeof(double));
+		if (!ns) { perror("tdd"); exit(1); }
+		static record extra;
+
+		for (unsigned i = 0; i < count; ++i) {
+			test_case* b = benchmarks[i];
+			char buf[512];
+			failure_count = 0;
+			benchmark = b;
+
+			unsigned long long iterations = 1;  // Calibration, which doubles as warmup.
+			for (sample(b, iterations); b->ns < target;) {
+				unsigned long long factor = b->ns ? target * 3 / 2 / b->ns : 10;
+				iterations *= factor < 2 ? 2 : factor > 10 ? 10 : factor;
+				sample(b, iterations);
+			}
+			sample(b, iterations);
+
+			double min = 1e300;
+			unsigned long long perf_start[max_events], perf[max_events];
+			if (event_count) perf_read(perf_start);
+			for (unsigned k = 0; k < samples; ++k) if ((ns[k] = sample(b, iterations)) < min) min = ns[k];
+			if (event_count) perf_read(perf);
+			release_fixtures(&outside, b->info);
+			benchmark = nullptr;
+			double med = median(ns, samples);
+			history_add(b, ns, samples);
+			for (unsigned k = 0; k < samples; ++k) ns[k] = ns[k] < med ? med - ns[k] : ns[k] - med;
+
+			double mad = median(ns, samples);
+
+			fprintf(text_out(), "%-32s %12.2f ns/op  mad %10.2f  min %12.2f  (%u x %llu)\n", describe(b, buf, sizeof buf), med, mad, min, samples, iterations);
+			extra.len = 0;
+			extra.addf(",\"ns_per_op\":%.3f,\"mad\":%.3f,\"min\":%.3f,\"iterations\":%llu", med, mad, min, iterations);
+			if (event_count) {
+				double ops = (double)samples * iterations;
+				fprintf(text_out(), "%-32s", "");
+				for (unsigned k = 0; k < event_count; ++k) fprintf(text_out(), " %s %.2f/op", events[k].name, (perf[k] - perf_start[k]) / ops);
+				fprintf(text_out(), "\n");
+				for (unsigned k = 0; k < event_count; ++k) perf[k] -= perf_start[k];
+				perf_json(extra, perf, ops);
+			}
+			b->ns = (unsigned long long)med;
+			report(b, failure_count ? "failed" : "passed", failures, failure_count, extra.data);
+			tally(counts.completed);
+		}
+		bench_iterations = 1;
+		free(ns);
+	}
+	// }}}
+
+	// manifest {{{
+	static char** filters;
+	static int filter_count;
+
+	static bool selected(const test_info* t) {
+		if (!filter_count) return true;
+		for (int i = 0; i < filter_count; ++i) if (!fnmatch(filters[i], t->name, 0)) return true;
+		return false;
+	}
+
+	static void list() {
+		static const char* const categories[] = {"TEST", "CTEST", "CRTEST", "BENCH", "CONCURRENT_TEST", "PROPERTY"};
+		for (test_info* t = first_info; t; t = t->next)
+			if (selected(t)) printf("%s:%u: %s(%s) x %u\n", t->file, t->line, categories[(int)t->cat], t->name, t->count);
+	}
+	// }}}
+
+	static void run_all() {
+		unsigned shard = 0, shards = 1;  // TDD_SHARD=i/N runs every N'th test, starting with the i'th.
+		if (const char* env = getenv("TDD_SHARD"))
+			if (sscanf(env, "%u/%u", &shard, &shards) != 2 || shard >= shards) {
+				fprintf(stderr, "TDD_SHARD must be i/N, with i < N\n");
+				exit(1);
+			}
+
+		for (test_info* t = first_info; t; t = t->next)  // Compile time tests passed already.
+			if ((t->cat == category::C || t->cat == category::CR) && selected(t)) tally(counts.completed, t->count);
+
+		unsigned count = 0, benchmarks = 0, index = 0;  // Tests at the front of cases, benchmarks after them.
+		for (test_case* t = first; t; t = t->next)
+			if (selected(t->info) && index++ % shards == shard) ++(t->info->cat == category::B ? benchmarks : count);
+		cases = (test_case**)malloc((count + benchmarks ? count + benchmarks : 1) * sizeof(test_case*));
+		if (!cases) { perror("tdd"); exit(1); }
+		test_case** bench = cases + count;
+		count = benchmarks = index = 0;
+		for (test_case* t = first; t; t = t->next)
+			if (selected(t->info) && index++ % shards == shard) {
+				if (t->info->cat == category::B) bench[benchmarks++] = t;
+				else cases[count++] = t;
+				++t->info->left;
+			}
+
+		budget = env_count("TDD_BUDGET_MS", TDD_BUDGET_MS, false) * 1000000ull;
+		default_timeout = env_count("TDD_TIMEOUT_MS", TDD_TIMEOUT_MS, false) * 1000000ull;
+		property_cases = env_count("TDD_CASES", TDD_CASES, false);
+		const char* seed = getenv("TDD_SEED");
+		property_seed = seed ? strtoull(seed, nullptr, 0) : TDD_SEED;
+		if (!property_seed) property_seed = now() ^ (unsigned long long)getpid() << 32;
+		log_cap = env_count("TDD_LOG_KB", TDD_LOG_KB, false) * 1024ull;
+		log_quiet = env_count("TDD_QUIET", TDD_QUIET, false);
+		if (log_cap) catch_crash_signals();
+		report_open();
+		history_open();
+		if (env_count("TDD_PERF", TDD_PERF, false)) perf_probe();
+		unsigned long long* perf = event_count ? (unsigned long long*)calloc(count ? count : 1, sizeof(unsigned long long[max_events])) : nullptr;
+		for (unsigned i = 0; perf && i < count; ++i) cases[i]->perf = perf + i * max_events;
+		if (unsigned forks = env_count("TDD_FORKS", TDD_FORKS, false); forks && count) run_forked(count, forks);
+		else run_threads(count);
+		report_times(count);
+		if (TDD_ALLOCS) report_allocs(count);
+		if (event_count) report_perf(count);
+		for (unsigned i = 0; *history_path && i < count; ++i) {
+			double ns = cases[i]->ns;
+			history_add(cases[i], &ns, 1);
+		}
+		if (env_count("TDD_BENCH", TDD_BENCH, false)) run_benchmarks(bench, benchmarks);
+		history_close();
+		close_fixtures();
+		free(cases);
+	}
+
+	static int summary() {
+		counters c = totals();
+		fprintf(text_out(), errors ?                "%llu tests, %llu assertions, %u errors.\n"
+		                           : "\x1B[32m\x1B[1m%llu tests, %llu assertions, %u errors.\n\x1B[0m",
+		        c.completed, c.passed + c.failed, errors);
+		return errors != 0;
+	}
+
+	#ifdef TDD_HOT_RELOAD
+	// serve {{{
+	// With --serve, every line on stdin names a shared object of test translation units. It replaces the one loaded
+	// from the same path, if any, and only its tests are run, in a child process so that crashes and TDD_MAX_ERRORS
+	// leave the server alive. The server must be linked with -rdynamic, so that the tests find enlist() and fail().
+	struct module {
+		char* path;
+		void* handle;
+		test_info* infos;  // What the module's static initialization enlisted.
+		test_case* cases;
+	};
+
+	static bool load(module& m) {
+		if (m.handle) dlclose(m.handle);  // GCC must compile modules with -fno-gnu-unique, or this does nothing.
+		first_info = nullptr; last_info = &first_info;
+		first = nullptr;      last = &first;
+		if (!(m.handle = dlopen(m.path, RTLD_NOW | RTLD_LOCAL))) {
+			fprintf(stderr, "%s\n", dlerror());
+			return false;
+		}
+		m.infos = first_info;
+		m.cases = first;
+		return true;
+	}
+
+	static void serve() {
+		module* modules = nullptr;
+		unsigned count = 0;
+		char line[4096];
+
+		while (fgets(line, sizeof line, stdin)) {
+			line[strcspn(line, "\n")] = 0;
+			if (!*line) continue;
+
+			unsigned i = 0;
+			while (i < count && strcmp(modules[i].path, line)) ++i;
+			if (i == count) {
+				modules = (module*)realloc(modules, ++count * sizeof(module));
+				if (!modules || !(modules[i].path = strdup(line))) { perror("tdd"); exit(1); }
+				modules[i].handle = nullptr;
+			}
+			if (!load(modules[i])) continue;
+
+			fflush(nullptr);
+			pid_t pid = fork();
+			if (pid < 0) { perror("tdd"); exit(1); }
+			if (pid == 0) {
+				first_info = modules[i].infos;
+				first = modules[i].cases;
+				run_all();
+				exit(summary());
+			}
+			int status;
+			waitpid(pid, &status, 0);
+			if (WIFSIGNALED(status))
+				fprintf(stderr, "\x1B[1m%s: \x1B[31merror:\x1B[0m crashed with signal %d (%s)\n", line, WTERMSIG(status), strsignal(WTERMSIG(status)));
+		}
+	}
+	// }}}
+	#endif
+}
+
+#if TDD_ALLOCS
+// allocations {{{
+// operator new and delete are not replaced: those of libstdc++ and libc++ call these.
+extern "C" {
+	void* __libc_malloc(size_t);
+	void* __libc_calloc(size_t, size_t);
+	void* __libc_realloc(void*, size_t);
+	void* __libc_memalign(size_t, size_t);
+	void  __libc_free(void*);
+
+	void* malloc(size_t n) { return tdd::_internal_tdd::counted(__libc_malloc(n), n); }
+	void* calloc(size_t n, size_t size) { return tdd::_internal_tdd::counted(__libc_calloc(n, size), n * size); }
+	void* memalign(size_t align, size_t n) { return tdd::_internal_tdd::counted(__libc_memalign(align, n), n); }
+	void* aligned_alloc(size_t align, size_t n) { return memalign(align, n); }
+	void* valloc(size_t n) { return memalign(sysconf(_SC_PAGESIZE), n); }
+
+	int posix_memalign(void** p, size_t align, size_t n) {
+		if (align % sizeof(void*) || (align & (align - 1))) return EINVAL;
+		void* q = memalign(align, n);
+		if (!q) return ENOMEM;
+		*p = q;
+		return 0;
+	}
+
+	void* realloc(void* p, size_t n) {
+		long long old = p ? (long long)malloc_usable_size(p) : 0;
+		void* q = __libc_realloc(p, n);
+		if (!q && n) return q;  // p is still allocated.
+		tdd::_internal_tdd::allocs.live -= old;
+		return tdd::_internal_tdd::counted(q, n);
+	}
+
+	void free(void* p) {
+		tdd::_internal_tdd::uncounted(p);
+		__libc_free(p);
+	}
 }
+// }}}
+#endif
+
+bool tdd::cancelled() noexcept {
+	using namespace tdd::_internal_tdd;
+	return current_watch && __atomic_load_n(&current_watch->cancelled, __ATOMIC_ACQUIRE);
+}
+
+int main(int argc, char** argv) {
+	using namespace tdd::_internal_tdd;
+
+	bool list_only = false;
+	#ifdef TDD_HOT_RELOAD
+	bool serve_only = false;
+	#endif
+	filters = argv + 1;
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--list")) list_only = true;
+		#ifdef TDD_HOT_RELOAD
+		else if (!strcmp(argv[i], "--serve")) serve_only = true;
+		#endif
+		else if (!strncmp(argv[i], "--filter=", 9)) filters[filter_count++] = argv[i] + 9;
+		else {
+			fprintf(stderr, "usage: %s [--list] [--filter=glob]...\n", argv[0]);
+			return 2;
+		}
+	}
+	if (list_only) return list(), 0;
+	#ifdef TDD_HOT_RELOAD
+	if (serve_only) return serve(), 0;
+	#endif
 
-int main() {
-	printf(tdd::_internal_tdd::errors ?                "%u tests, %u errors.\n"
-	                                  : "\x1B[32m\x1B[1m%u tests, %u errors.\n\x1B[0m",
-	       tdd::_internal_tdd::completed, tdd::_internal_tdd::errors);
-	return tdd::_internal_tdd::errors != 0;
+	run_all();
+	return summary();
 }
@@ -47,6 +47,7 @@ namespace tdd::_internal_tdd {
 
 	template<class... T> struct type_list { static constexpr size_t size = sizeof...(T); };
 	template<template<class...> class... TT> struct template_list { constexpr static size_t size = sizeof...(TT); };
+	template<class T> struct type_wrapper { using type = T; };
 
 	// constant {{{
 	template<auto value>
@@ -257,21 +258,44 @@ namespace tdd::_internal_tdd {
 	#endif
 	
 	struct global_counter_tag{};
-	
-	template<class T = global_counter_tag, int N = 0, auto = []{}>
+
+	// Indices 0 to N - 1 are defined. Probe 0, 1, 3, 7, ... until one is not, then bisect: O(log N) instantiations.
+	// Unique makes every count instantiate anew.
+	template<class T, int Lo, int Hi, auto Unique>  // Hi is not defined, Lo - 1 is.
+	consteval int _counter_search() {
+		if constexpr(Lo == Hi) return Lo;
+		else if constexpr(const_counter_t<T, (Lo + Hi) / 2>::get(0)) return _counter_search<T, (Lo + Hi) / 2 + 1, Hi, Unique>();
+		else return _counter_search<T, Lo, (Lo + Hi) / 2, Unique>();
+	}
+
+	template<class T, int N, auto Unique>
+	consteval int _counter_probe() {
+		if constexpr(const_counter_t<T, N>::get(0)) return _counter_probe<T, 2 * N + 1, Unique>();
+		else return _counter_search<T, (N + 1) / 2, N, Unique>();
+	}
+
+	// Returns the count and increments it.
+	template<class T = global_counter_tag, auto Unique = []{}>
 	consteval int const_counter() {
-		if constexpr(const_counter_t<T, N>::set(N))
-			return const_counter<T, N + 1>();
-		else return N;
+		constexpr int N = _counter_probe<T, 0, Unique>();
+		return const_counter_t<T, N>::set(0), N;
 	}
-	
-	template<class T = global_counter_tag, int N = 0, auto = []{}>
+
+	template<class T = global_counter_tag, auto Unique = []{}>
 	consteval int check_const_counter() {
-		if constexpr(const_counter_t<T, N>::get(N))
-			return check_const_counter<T, N + 1>();
-		else return N;
+		return _counter_probe<T, 0, Unique>();
 	}
 	// }}}
+	// int_seq {{{
+	template<int... I> struct int_seq { constexpr static size_t size = sizeof...(I); };
+
+	#if __has_builtin(__make_integer_seq)
+	template<class, int... I> struct _int_seq_aux { using type = int_seq<I...>; };
+	template<int N> using make_int_seq = typename __make_integer_seq<_int_seq_aux, int, N>::type;
+	#else
+	template<int N> using make_int_seq = int_seq<__integer_pack(N)...>;
+	#endif
+	// }}}
 	// NATTED {{{
 	// A technique to modify template parameters one at a time.
 	// 
@@ -309,14 +333,28 @@ namespace tdd::_internal_tdd {
 		template<class... T> using C = typename C##_t<0, T..., C##_NAT>::type
 	// }}}
 	// nth {{{
-	NATTED2(_nth_base);
-	NATTED2(_nth_value_base);
-	template<int I, class T, class... Ts> struct         _nth_base_t<I, constant<I>, T, Ts...> { using type = T; };
-	template<int I, class T, class... Ts> struct   _nth_value_base_t<I, constant<I>, T, Ts...> { using type = T; };
-	template<int I, class... T> using nth = _nth_base<constant<I>, T...>;
+	// Pack indexing without recursion: _nth_t derives from one _index<I, T> per type, and deduction picks the base for I.
+	template<int I, class T> struct _index {};
+
+	template<class Seq, class... T> struct _nth_t;
+	template<int... I, class... T>
+	struct _nth_t<int_seq<I...>, T...> : _index<I, T>... {
+		template<int N, class U> static type_wrapper<U> select(_index<N, U>*);
+		template<int N>          static type_wrapper<type_list<T...>> select(...);  // Out of bounds.
+	};
+
+	template<int I, class... T>
+	using nth = typename decltype(_nth_t<make_int_seq<sizeof...(T)>, T...>::template select<I>(
+	                              (_nth_t<make_int_seq<sizeof...(T)>, T...>*)nullptr))::type;
 
 	template<int I, auto... X>
-	constexpr auto nth_value = _nth_value_base<constant<I>, constant<X>...>::v;
+	constexpr auto nth_value = nth<I, constant<X>...>::v;
+	// }}}
+	// concat {{{
+	// concat<type_list<A>, type_list<B, C>> = type_list<A, B, C>, as a fold instead of recursion.
+	template<class... T, class... U> type_list<T..., U...> operator+(type_list<T...>, type_list<U...>);
+
+	template<class... Lists> using concat = decltype((type_list<>() + ... + Lists()));
 	// }}}
 	// value_list {{{
 	template<auto... V>
@@ -386,6 +424,7 @@ namespace tdd::_internal_tdd {
 	// store::push<void>();                   // store::current_type<> = type_list<void>
 	//
 	// This is accomplished by defining a friend function every time a type is added, i.e. friend injection.
+	// The N'th type gets its own function, so a push costs O(log N) instantiations, and current_type joins them all at once.
 	//
 	#if defined(__clang__)
 		#pragma clang diagnostic push
@@ -398,39 +437,37 @@ namespace tdd::_internal_tdd {
 	
 	template<class Tag>
 	class type_vec {
-		template<int N, class = NAT>  // The N'th type is stored in _aux_is_defined()'s return value.
+		template<int N>  // The N'th type is stored in _aux_is_defined()'s return value.
 		struct store {
 			friend constexpr auto _aux_is_defined(store<N>);
 			constexpr static int v = N;
 		};
 
-		template<class T>  // Default is type_list<>.
-		class store<0, T> {
-			friend constexpr auto _aux_is_defined(store<0>) { return type_list<>(); }
-		};
-
 		template<class Store, class T>
 		struct _aux_define {
-			friend constexpr auto _aux_is_defined(store<Store::v>) { return T(); }
+			friend constexpr auto _aux_is_defined(store<Store::v>) { return type_wrapper<T>(); }
 			constexpr static int v = Store::v;
 		};
 
 		template<class T,
 		         class V = type_vec,
-				 class New = typename V::template store<const_counter<V>() + 1>>
+				 class New = typename V::template store<const_counter<V>()>>
 		constexpr static int add_type(int R = _aux_define<New, T>::v) { return R; }
 
+		template<class V, int... I>
+		static auto join(int_seq<I...>) -> type_list<typename decltype(_aux_is_defined(typename V::template store<I>()))::type...>;
+
 	public:
 		template<class V = type_vec,
 		         int N = check_const_counter<V>()>
-		using current_store = typename V::template store<N>;
+		constexpr static int current_size = N;
 
 		template<class V = type_vec,
-		         class Store = typename V::template current_store<>>
-		using current_type = decltype(_aux_is_defined(Store()));
+		         class Seq = make_int_seq<V::template current_size<>>>
+		using current_type = decltype(join<V>(Seq()));
 
 		template<class... T, class V = type_vec>
-		constexpr static void push(int R = add_type<append_params<typename V::template current_type<>, T...>>()) {}
+		constexpr static void push(int R = (V::template add_type<T>(), ..., 0)) {}
 	};
 
 	#if defined(__clang__)
@@ -455,31 +492,42 @@ namespace tdd::_internal_tdd {
 
 	template<int L> struct seq<L, _seq_nat, _seq_nat> : seq<0, 1, L> {};
 	template<int F, int L> struct seq<F, L, _seq_nat> : seq<F, 1, L> {};
+
+	// Like seq<>, but one parameter set for all values, which a runtime test sweeps. The body reads the current one as
+	// X::v, at runtime only.
+	template<long long F, long long S, long long L>
+	struct _rseq {
+		static_assert(S != 0, "rseq: step must not be 0");
+		using rseq_type = _rseq;
+		constexpr static long long first = F;
+		constexpr static long long step  = S;
+		constexpr static long long last  = L;
+		constexpr static unsigned long long size = 1 + ((F < L) ? (unsigned long long)(L - F) : (unsigned long long)(F - L))
+		                                               / ((S < 0) ? 0ull - S : (unsigned long long)S);
+		static inline thread_local long long v = F;
+	};
+
+	template<auto F, auto S = _seq_nat, auto L = _seq_nat> struct rseq : _rseq<F, S, L> {};
+	template<auto L> struct rseq<L, _seq_nat, _seq_nat> : _rseq<0, 1, L> {};
+	template<auto F, auto L> struct rseq<F, L, _seq_nat> : _rseq<F, 1, L> {};
 	// }}}
 	// type_variant {{{
-	NATTED(_unpack_sets);
-	template<class... T, class... Ts> struct _unpack_sets_t<     set<T...>, Ts...> : _unpack_sets_t<T..., Ts...> {};
-	template<class... T, class... Ts> struct _unpack_sets_t<for_each<T...>, Ts...> : _unpack_sets_t<T..., Ts...> {};
+	// Flatten set<>s and for_each<>s into one type_list.
+	template<class T>    struct _unpack_t                 { using type = type_list<T>; };
+	template<class... T> struct _unpack_t<     set<T...>> { using type = concat<typename _unpack_t<T>::type...>; };
+	template<class... T> struct _unpack_t<for_each<T...>> { using type = concat<typename _unpack_t<T>::type...>; };
 
-	template<template<class> class> struct _variant_pkg {};
+	template<class... T> using _unpack_sets = concat<typename _unpack_t<T>::type...>;
 
-	NATTED2(_expand_variants);
-	template<int I, template<class> class V, class T, class... Ts>     // Normal type.
-	struct _expand_variants_t<I, _variant_pkg<V>, T, Ts...>
-		: _expand_variants_t<I, _variant_pkg<V>, Ts..., T, typename V<T>::type> {};
+	template<template<class> class V, class T>                         // Normal type.
+	struct _expand_variants_t { using type = type_list<T, typename V<T>::type>; };
 
-	template<int I, template<class> class V, class... T, class... Ts>  // Join other set<>s.
-	struct _expand_variants_t<I, _variant_pkg<V>, set<T...>, Ts...>
-		: _expand_variants_t<I, _variant_pkg<V>, T..., Ts...> {};
-
-	template<int I, template<class> class V, class... T>               // Final: unpack set<>s produced by the variant.
-	struct _expand_variants_t<I, _variant_pkg<V>, _expand_variants_NAT, T...> {
-		using type = template_cast<set, _unpack_sets<T...>>;
-	};
+	template<template<class> class V, class... T>                      // Join other set<>s.
+	struct _expand_variants_t<V, set<T...>> { using type = concat<typename _expand_variants_t<V, T>::type...>; };
 
 	template<template<class> class Variant, class... T>
-	struct type_variant_t {
-		using type = _expand_variants<_variant_pkg<Variant>, T...>;
+	struct type_variant_t {                                            // Unpack set<>s produced by the variant.
+		using type = template_cast<set, template_cast<_unpack_sets, concat<typename _expand_variants_t<Variant, T>::type...>>>;
 	};
 	// }}}
 	// classes {{{
@@ -497,16 +545,16 @@ namespace tdd::_internal_tdd {
 		// cast_template {{{
 		// cast_template<To, From,
 		//               int, A<char>, From<void>> = type_list<int, A<char>, To<void>>
-		NATTED2(cast_template_base);
-		template<int I, template<class...> class To, template<class...> class From,
-				 class... T, class... Ts>
-		struct cast_template_base_t<I, template_list<To, From>, From<T...>, Ts...>
-			 : cast_template_base_t<I, template_list<To, From>, Ts..., To<T...>> {};
+		template<template<class...> class To, template<class...> class From, class T>
+		struct cast_template_t { using type = T; };
+
+		template<template<class...> class To, template<class...> class From, class... T>
+		struct cast_template_t<To, From, From<T...>> { using type = To<T...>; };
 
 		template<template<class...> class To,
 		         template<class...> class From,
 				 class... T>
-		using cast_template = cast_template_base<template_list<To, From>, T...>;
+		using cast_template = type_list<typename cast_template_t<To, From, T>::type...>;
 		// }}}
 		// expand_for_each {{{
 		// expand_for_each<type_list<type_list<A>, type_list<B>, type_list<C>>,  // Save
@@ -514,39 +562,32 @@ namespace tdd::_internal_tdd {
 		//
 		// = type_list<type_list<X, A>, type_list<X, B>, type_list<X, C>>,
 		//             type_list<Y, A>, type_list<Y, B>, type_list<Y, C>>>
-		NATTED2(expand_for_each);
-		template<int I, class... Save, class F, class... Ts>
-		struct expand_for_each_t<I, type_list<Save...>, F, Ts...>
-			: expand_for_each_t<I, type_list<Save...>, Ts..., insert_params<Save, F>...> {};
+		template<class Seq, class Save, class... F> struct expand_for_each_t;
+		template<int... I, class... Save, class... F>
+		struct expand_for_each_t<int_seq<I...>, type_list<Save...>, F...> {
+			using type = type_list<insert_params<nth<I % sizeof...(Save), Save...>, nth<I / sizeof...(Save), F...>>...>;
+		};
 
-		template<int I, class... Save, class... Ts>
-		struct expand_for_each_t<I, type_list<Save...>, expand_for_each_NAT, Ts...> { using type = type_list<Ts...>; };
+		template<class Save, class... F>
+		using expand_for_each = typename expand_for_each_t<make_int_seq<Save::size * sizeof...(F)>, Save, F...>::type;
 		// }}}
 		// expand_set {{{
-		template<size_t N, class Save, class Set, class...> struct expand_set_t;
-		template<size_t N, class T, class... Ts, class S, class... Ss, class... Result>
-		struct expand_set_t<N, type_list<T, Ts...>, type_list<S, Ss...>, Result...>
-			: expand_set_t<N - 1, type_list<Ts..., T>, type_list<Ss..., S>, Result..., insert_params<T, S>>
-		{};
-
-		template<class T, class... Ts, class S, class... Ss, class... Result>
-		struct expand_set_t<0, type_list<T, Ts...>, type_list<S, Ss...>, Result...> {
-			using type = type_list<Result...>;
+		// The i'th result pairs the i'th of Save and Set. The shorter one repeats from the start, as if rotated.
+		template<class Seq, class Save, class Set> struct expand_set_t;
+		template<int... I, class... Save, class... S>
+		struct expand_set_t<int_seq<I...>, type_list<Save...>, type_list<S...>> {
+			using type = type_list<insert_params<nth<I % sizeof...(Save), Save...>, nth<I % sizeof...(S), S...>>...>;
 		};
 
 		template<class Save, class Set>
-		using expand_set = typename expand_set_t<(Save::size > Set::size) ? Save::size : Set::size, Save, Set>::type;
+		using expand_set = typename expand_set_t<make_int_seq<(Save::size > Set::size) ? Save::size : Set::size>, Save, Set>::type;
 		// }}}
 		// expand_seq {{{
-		template<size_t N, class Save, int First, int Step, class...> struct expand_seq_t;
-		template<size_t N, class T, class... Ts, int I, int Step, class... Result>
-		struct expand_seq_t<N, type_list<T, Ts...>, I, Step, Result...>
-			: expand_seq_t<N - 1, type_list<Ts..., T>, I + Step, Step, Result..., insert_params<T, constant<I>>>
-		{};
-
-		template<class T, class... Ts, int I, int Step, class... Result>
-		struct expand_seq_t<0, type_list<T, Ts...>, I, Step, Result...> {
-			using type = type_list<Result...>;
+		// As many results as the seq has values; Save repeats from the start.
+		template<class Seq, class Save, int First, int Step> struct expand_seq_t;
+		template<int... I, class... Save, int First, int Step>
+		struct expand_seq_t<int_seq<I...>, type_list<Save...>, First, Step> {
+			using type = type_list<insert_params<nth<I % sizeof...(Save), Save...>, constant<First + I * Step>>...>;
 		};
 		// }}}
 		// expand: Build a list of all parameter sets, with all set/for_each resolved.
@@ -564,7 +605,7 @@ namespace tdd::_internal_tdd {
 		template<class Save, auto... Seq, class... Ts>  // seq<>
 		struct expand_t<Save, seq<Seq...>, Ts...> {
 			using S = seq<Seq...>;
-			using type = typename expand_t<typename expand_seq_t<S::size, Save, S::first, S::step>::type, Ts...>::type;
+			using type = typename expand_t<typename expand_seq_t<make_int_seq<S::size>, Save, S::first, S::step>::type, Ts...>::type;
 		};
 
 		template<class Save, class T, class... Ts>  // normal type
@@ -648,6 +689,7 @@ namespace tdd {
 	using _internal_tdd::set;
 	using _internal_tdd::for_each;
 	using _internal_tdd::seq;
+	using _internal_tdd::rseq;
 	using _internal_tdd::type_variant;
 	using _internal_tdd::classes;
 	using _internal_tdd::and_const;
@@ -663,11 +705,68 @@ namespace tdd {
 
 	namespace _internal_tdd {
 		extern unsigned errors;
-		extern unsigned completed;
 
-		enum class category { R, C, CR };  // Runtime? Compile time?
+		enum class category { R, C, CR, B, MT, P };  // Runtime? Compile time? Benchmark? On several threads? Property?
+
+		// Tests are collected during static initialization and runtime tests are run by main() in tdd.cpp.
+		struct test_info {              // One per TEST, listed by --list.
+			const char* name;
+			const char* file;
+			unsigned line;
+			category cat;
+			unsigned count;             // Number of parameter sets.
+			unsigned threads;           // Of a CONCURRENT_TEST. 0 runs it on 1, 2, 4, ... up to all cores.
+			test_info* next = nullptr;
+			mutable unsigned left = 0;  // Parameter sets still to run, after which its per::family fixtures go.
+		};
+
+		struct test_case {              // One per runtime parameter set.
+			void (*call)();
+			const test_info* info;
+			const char* params;         // type_names<Params...>()
+			unsigned long long values = 0;                     // Combinations of its rseq<>s, or 0.
+			void (*at)(unsigned long long, bool) = nullptr;    // Sets the rseq<>s to a combination, and prints it.
+			test_case* next = nullptr;
+			unsigned long long ns = 0;  // Duration of call().
+			unsigned long long allocs = 0, alloc_bytes = 0, peak_bytes = 0;  // With TDD_ALLOCS.
+			unsigned long long* perf = nullptr;  // With TDD_PERF, a count per event.
+		};
+
+		void enlist(test_info* t) noexcept;
+		void enlist(test_case* t) noexcept;
+
+		// Counts per thread, summed up by tdd.cpp for the summary. Only their own thread writes them, so passing
+		// assertions in many threads share no cache line.
+		struct counters {
+			unsigned long long passed;     // Assertions.
+			unsigned long long failed;
+			unsigned long long completed;  // Tests.
+			counters* next;                // Of all threads that counted something.
+			bool enlisted;
+		};
+
+		extern thread_local constinit counters counts;
+
+		[[gnu::cold]] void enlist(counters* c) noexcept;  // Until its thread exits.
 
-		template<class T> struct type_wrapper { using type = T; };
+		inline void tally(unsigned long long& n, unsigned long long k = 1) noexcept {
+			if (!counts.enlisted) [[unlikely]] enlist(&counts);
+			__atomic_store_n(&n, n + k, __ATOMIC_RELAXED);  // Read by other threads, but written only by this one: a plain add.
+		}
+
+		// Reports a runtime error of the current test and exits after max_errors errors.
+		// Counts the assertion but returns false without reporting while a PROPERTY searches or shrinks, or an rseq sweep
+		// probes, so that nothing is streamed.
+		// Cold and never inlined, also with LTO, so that EXPECT in a hot loop stays a compare and a branch.
+		[[gnu::cold]] [[gnu::noinline]] bool fail(const char* file, size_t line, const char* msg, unsigned max_errors) noexcept;
+
+		// Prints to the log of the current runtime test, which goes out when the test ends, or to stderr outside of one.
+		[[gnu::format(printf, 1, 2)]] void print(const char* format, ...) noexcept;
+
+		// The compiler spells out T in __PRETTY_FUNCTION__, which tdd.cpp takes apart for reports.
+		template<class... T> constexpr const char* type_names() { return __PRETTY_FUNCTION__; }
+
+		extern unsigned long long bench_iterations;  // How many times a benchmark's call() runs its body.
 
 		template<class PointerClass, class Object>
 		constexpr bool related_pointer = is_same<naked<PointerClass>, naked<Object>> || is_base_of<PointerClass, Object>;
@@ -790,41 +889,82 @@ namespace tdd {
 		template<class... T> struct unwrap_parameters                   { using type = type_list<T...>; };
 		template<class... T> struct unwrap_parameters<parameters<T...>> { using type = type_list<T...>; };
 
-		template<class Tests>
-		class exec {
-			template<class Test>
-			class gen_all_tests {
-				template<auto F>
-				class exec_test_t {
-					consteval static void constcall() { F(); }
-					static void call() { F(); }
-				public:
-					exec_test_t() noexcept {
-						if constexpr(Test::_test_internals_::cat != category::R) { constcall(); ++completed; }
-						if constexpr(Test::_test_internals_::cat != category::C) {      call(); ++completed; }
+		template<class T> constexpr bool is_rseq = requires { typename T::rseq_type; };
+
+		// Every combination of the rseq<>s in Params, by index. The first one changes slowest, like nested loops.
+		template<class... Params>
+		struct rseq_values {
+			template<class P> consteval static unsigned long long size_of() {
+				if constexpr(is_rseq<P>) return P::size;
+				else return 1;
+			}
+
+			constexpr static unsigned long long values = (is_rseq<Params> || ...) ? (1ull * ... * size_of<Params>()) : 0;
+
+			static void at(unsigned long long i, bool show) {
+				unsigned long long rest = values;
+				([&] {
+					if constexpr(is_rseq<Params>) {
+						rest /= Params::size;
+						Params::v = Params::first + (long long)(i / rest % Params::size) * Params::step;
+						if (show) print("    at %lld\n", Params::v);
 					}
-				};
+				}(), ...);
+			}
+		};
+
+		// Outside of exec, so that the symbols of a test do not spell out every other test.
+		template<class Test>
+		class gen_all_tests {
+			template<auto F, class... Params>
+			class exec_test_t {
+				constexpr static category cat = Test::_test_internals_::cat;
+
+				consteval static void constcall() { F(); }
+				static void call() {
+					if constexpr(cat == category::B) for (auto n = bench_iterations; n; --n) F();
+					else F();
+				}
 
-				template<class... T> using function = member_ptr<&Test::template body<nth<0, T...>, T...>>;
-				template<class... T> using exec_test = exec_test_t<function<T...>::dereference()>;
-				template<class... T> using make_exec_tests = classes<exec_test, T...>;
+				using swept = rseq_values<Params...>;
+				static_assert(!swept::values || cat == category::R, "rseq<> is for TESTX, seq<> for compile time tests");
 
-				using P = typename unwrap_parameters<typename Test::_test_internals_::access::param>::type;
+				static inline test_case runtime{&call, &gen_all_tests::info, type_names<Params...>(),
+				                                swept::values, swept::values ? &swept::at : nullptr};
 			public:
-				using type = template_cast<make_exec_tests, P>;
+				exec_test_t() noexcept {
+					if constexpr(cat == category::C || cat == category::CR) constcall();  // Counted by main().
+					if constexpr(cat != category::C) enlist(&runtime);
+				}
 			};
 
-			template<int I = 0>
-			void exec_all() {
-				if constexpr(I < Tests::size) {
-					using Test = get_param<I, Tests>;
-					instantiate<typename gen_all_tests<Test>::type>();
-					exec_all<I + 1>();
-				}
+			template<class... T> using function = member_ptr<&Test::template body<nth<0, T...>, T...>>;
+			template<class... T> using exec_test = exec_test_t<function<T...>::dereference(), T...>;
+			template<class... T> using make_exec_tests = classes<exec_test, T...>;
+
+			using P = typename unwrap_parameters<typename Test::_test_internals_::access::param>::type;
+		public:
+			using type = template_cast<make_exec_tests, P>;
+
+			using internals = typename Test::_test_internals_;
+			static inline test_info info{internals::name, internals::file, internals::line, internals::cat, type::size, internals::threads};
+
+			template<class... E>  // One temporary each, instead of a tuple that nests as deep as there are parameter sets.
+			static void construct(type_list<E...>) { (E(), ...); }
+
+			static void exec() {
+				enlist(&info);
+				construct(type());
 			}
+		};
+
+		template<class Tests>
+		class exec {
+			template<class... Test>  // A fold, not recursion: the depth does not grow with the number of tests.
+			static void exec_all(type_list<Test...>) { (gen_all_tests<Test>::exec(), ...); }
 
 		public:
-			exec() noexcept { exec_all(); }
+			exec() noexcept { exec_all(Tests()); }
 		};
 		// }}}
 	} // _internal_tdd
@@ -846,7 +986,7 @@ namespace tdd {
 
 		template<class... Args>
 		constexpr const printer_t& print(Args&&... args) const {
-			if (prt) fprintf(stderr, _internal_tdd::forward<Args>(args)...);
+			if (prt) _internal_tdd::print(_internal_tdd::forward<Args>(args)...);
 			return *this;
 		}
 	};
@@ -856,6 +996,9 @@ namespace tdd {
 
 	template<bool prt> 
 	constexpr printer_t printer(prt);
+
+	// What EXPECT() and friends stream into once they failed. Before that, the streamed operands are not evaluated.
+	constexpr const printer_t& failed() noexcept { return printer<true>; }
 	
 	#if defined(__clang__)
 		#pragma clang diagnostic pop
@@ -863,21 +1006,322 @@ namespace tdd {
 	// }}}
 
 	constexpr printer_t expect(bool cond, const char* file, size_t line, const char* msg) {
-		if (cond) return printer<false>;
+		if (cond) [[likely]] {
+			if (!_internal_tdd::is_constant_evaluated()) _internal_tdd::tally(_internal_tdd::counts.passed);
+			return printer<false>;
+		}
 		if (_internal_tdd::is_constant_evaluated())
 			return (3 / (0 + cond)); // error: EXPECT() failed
-		else {  // runtime error
-			fprintf(stderr, "\x1B[1m%s:%lu: \x1B[31merror:\x1B[0m expected %s\n", file, line, msg);
-			if (TDD_MAX_ERRORS == (__atomic_fetch_add(&_internal_tdd::errors, 1, __ATOMIC_RELAXED) + 1))
-				exit(_internal_tdd::errors);
-		}
+		else if (!_internal_tdd::fail(file, line, msg, TDD_MAX_ERRORS))  // runtime error
+			return printer<false>;
 		return printer<true>;
 	}
 
+	// bench {{{
+	// Keep the optimizer from discarding a value or from assuming anything about memory in benchmarks.
+	template<class T> inline void do_not_optimize(const T& v) { asm volatile("" : : "r,m"(v) : "memory"); }
+	#if defined(__clang__)
+	template<class T> inline void do_not_optimize(T& v)       { asm volatile("" : "+r,m"(v) : : "memory"); }
+	#else
+	template<class T> inline void do_not_optimize(T& v)       { asm volatile("" : "+m,r"(v) : : "memory"); }
+	#endif
+	inline void clobber() { asm volatile("" : : : "memory"); }
+	// }}}
+
+	// concurrent {{{
+	namespace _internal_tdd {
+		extern thread_local constinit unsigned thread_index;
+		extern thread_local constinit unsigned long long thread_ops;
+	}
+
+	// Which of the threads of a CONCURRENT_TEST this is, from 0.
+	inline unsigned thread_index() noexcept { return _internal_tdd::thread_index; }
+
+	// Counts n operations of this thread, which the CONCURRENT_TEST reports per second.
+	inline void ops(unsigned long long n = 1) noexcept { _internal_tdd::thread_ops += n; }
+	// }}}
+
+	// property {{{
+	namespace _internal_tdd {
+		// A choice in [0, max] for the current PROPERTY case: random while searching, replayed while shrinking, which
+		// tries smaller choices. Generators turn smaller choices into simpler values.
+		unsigned long long choose(unsigned long long max) noexcept;
+
+		extern thread_local constinit bool showing;  // In the final run of a falsified PROPERTY, which prints its values.
+
+		template<class T> constexpr bool is_float = is_any_of<T, float, double, long double>;
+
+		template<class T>
+		void show(T v) {
+			if constexpr(is_float<T>)  printer<true>.print("    drew %.17g\n", (double)v);
+			else if (T(-1) < T(0))     printer<true>.print("    drew %lld\n", (long long)v);
+			else                       printer<true>.print("    drew %llu\n", (unsigned long long)v);
+		}
+	}
+
+	// A value in [lo, hi] for a PROPERTY, which shrinks towards 0, or towards the bound closest to it.
+	template<class T>
+	T any(T lo, T hi) noexcept {
+		T v;
+		if constexpr(_internal_tdd::is_float<T>) {
+			constexpr unsigned long long one = 1ull << 53;
+			unsigned long long c = _internal_tdd::choose(2 * one + 1);  // The lowest bit is the sign.
+			T f = T(c >> 1) / T(one);
+			if (lo <= T(0) && T(0) <= hi) v = c & 1 ? lo * f : hi * f;
+			else if (lo > T(0))          v = lo + (hi - lo) * f;
+			else                         v = hi - (hi - lo) * f;
+			v = v < lo ? lo : v > hi ? hi : v;
+		} else {
+			using U = unsigned long long;
+			U c = _internal_tdd::choose(U(hi) - U(lo));
+			if (lo <= T(0) && T(0) <= hi) {  // 0, -1, 1, -2, 2, ... until one side ends.
+				U neg = U(0) - U(lo), n = neg < U(hi) ? neg : U(hi);
+				if (c <= 2 * n)        v = c % 2 ? T(U(0) - (c + 1) / 2) : T(c / 2);
+				else if (U(hi) > neg)  v = T(c - n);
+				else                   v = T(U(0) - (c - n));
+			}
+			else if (lo > T(0)) v = T(U(lo) + c);
+			else                v = T(U(hi) - c);
+		}
+		if (_internal_tdd::showing) _internal_tdd::show(v);
+		return v;
+	}
+
+	// Any integer of type T.
+	template<class T>
+	T any() noexcept {
+		if constexpr(T(-1) < T(0)) {
+			constexpr T max = T(~0ull >> (65 - 8 * sizeof(T)));
+			return any<T>(-max - 1, max);
+		}
+		else return any<T>(0, T(~T(0)));
+	}
+
+	inline size_t any_size(size_t max) noexcept { return any<size_t>(0, max); }
+
+	// n bytes for a PROPERTY, which shrink towards 0.
+	inline void any_bytes(void* p, size_t n) noexcept {
+		unsigned char* b = (unsigned char*)p;
+		for (size_t i = 0; i < n; i += 8) {
+			unsigned long long c = _internal_tdd::choose(~0ull);
+			for (size_t k = 0; k < 8 && i + k < n; ++k) b[i + k] = (unsigned char)(c >> 8 * k);
+		}
+		if (_internal_tdd::showing) {
+			printer<true>.print("    drew %zu bytes:", n);
+			for (size_t i = 0; i < n && i < 64; ++i) printer<true>.print(" %02x", b[i]);
+			printer<true>.print("%s\n", n > 64 ? " ..." : "");
+		}
+	}
+	// }}}
+
+	// timeout {{{
+	namespace _internal_tdd {
+		void set_timeout(unsigned ms) noexcept;
+	}
+
+	// Limits the current runtime test to ms milliseconds from its start, instead of TDD_TIMEOUT_MS. 0 means no limit.
+	constexpr void timeout_ms(unsigned ms) { if (!_internal_tdd::is_constant_evaluated()) _internal_tdd::set_timeout(ms); }
+
+	// True once the current runtime test has run out of time. Long loops can check it and return early.
+	bool cancelled() noexcept;
+	// }}}
+
+	// fixtures {{{
+	// How long an instance of a fixture serves: one parameter set, all parameter sets of one TESTX, or the whole run.
+	enum class per { test, family, binary };
+
+	namespace _internal_tdd {
+		struct fixture_type {
+			per scope;
+			void* (*make)();
+			void (*reset)(void*);  // nullptr without T::reset().
+			void (*destroy)(void*);
+		};
+
+		// The current test's instance: the one it holds already, a free one from the pool after reset(), or a new one.
+		void* take(const fixture_type& f) noexcept;
+
+		template<class T> void* make_fixture() { return new T(); }
+		template<class T> void reset_fixture(void* p) { ((T*)p)->reset(); }
+		template<class T> void destroy_fixture(void* p) { delete (T*)p; }
+
+		template<class T>
+		consteval void (*reset_of())(void*) {
+			if constexpr(requires(T& f) { f.reset(); }) return &reset_fixture<T>;
+			else return nullptr;
+		}
+
+		template<class T, per S>
+		inline constexpr fixture_type fixture_of{S, &make_fixture<T>, reset_of<T>(), &destroy_fixture<T>};
+	}
+
+	// A T that is built on first use and then lent to one runtime test at a time, with T::reset(), if there is one,
+	// called before every test after the first. All threads of a test share it; tests that run at the same time get
+	// their own.
+	template<class T, per S = per::binary>
+	T& fixture() noexcept { return *(T*)_internal_tdd::take(_internal_tdd::fixture_of<T, S>); }
+	// }}}
+
+	// allocations {{{
+	namespace _internal_tdd {
+		struct alloc_counts {
+			unsigned long long count, bytes;  // Allocations, and the bytes asked for.
+			long long live, peak;             // Usable bytes. Blocks freed here count even if another thread allocated them.
+		};
+
+		// Of this thread, counted only if tdd.cpp is compiled with TDD_ALLOCS=1.
+		extern thread_local constinit alloc_counts allocs;
+
+		class alloc_scope {
+			const char* file;
+			size_t line;
+			const char* msg;
+			unsigned long long max, start;
+			bool entered = false;
+		public:
+			alloc_scope(const char* file, size_t line, const char* msg, unsigned long long max) noexcept
+				: file(file), line(line), msg(msg), max(max), start(allocs.count) {}
+			bool enter() noexcept { return !entered && (entered = true); }
+			~alloc_scope() {  // Also after break or return.
+				unsigned long long n = allocs.count - start;
+				if (!expect(n <= max, file, line, msg)) printer<true>.print("    %llu allocations\n", n);
+			}
+		};
+	}
+	// }}}
+
+	// ranges {{{
+	namespace _internal_tdd {
+		// Offset of the first byte at which [a, a + n) and [b, b + n) differ, or n. Uses AVX2 or SSE2, whichever the CPU has.
+		size_t mismatch(const void* a, const void* b, size_t n) noexcept;
+
+		// How many of the n elements of size bytes differ, from the first one that does.
+		size_t count_mismatches(const void* a, const void* b, size_t n, size_t size, size_t first) noexcept;
+
+		enum class element { hex, sint, uint, real };
+
+		template<class T>
+		consteval element element_of() {
+			if constexpr(is_float<T>) return element::real;
+			else if constexpr(sizeof(T) > 1 && is_any_of<T, short, int, long, long long>) return element::sint;
+			else if constexpr(sizeof(T) > 1 && is_any_of<T, unsigned short, unsigned, unsigned long, unsigned long long>)
+				return element::uint;
+			else return element::hex;  // Bytes and everything else.
+		}
+
+		// Prints how many elements differ and the rows around the first one, instead of all of them.
+		[[gnu::cold]] void print_mismatch(const void* a, size_t na, const void* b, size_t nb, size_t size, element e,
+		                                  bool (*equal)(const void*, const void*, size_t), size_t first, size_t count) noexcept;
+
+		template<class T>
+		bool equal_at(const void* a, const void* b, size_t i) { return ((const T*)a)[i] == ((const T*)b)[i]; }
+
+		template<class T, size_t N> constexpr const T* span_data(const T (&a)[N])                      { return a; }
+		template<class T> requires(requires(const T& a) { a.data(); }) constexpr auto span_data(const T& a) { return a.data(); }
+		template<class T, size_t N> constexpr size_t span_size(const T (&)[N])                         { return N; }
+		template<class T> requires(requires(const T& a) { a.size(); }) constexpr size_t span_size(const T& a) { return a.size(); }
+	}
+
+	// Compares na elements of a with nb elements of b. Elements that are equal exactly when their bytes are, unlike floats
+	// or padded structs, are compared as memory, in bulk.
+	template<class T>
+	constexpr printer_t range_eq(const char* file, size_t line, const char* msg,
+	                             const T* a, size_t na, const T* b, size_t nb) {
+		size_t n = na < nb ? na : nb, first = 0;
+		constexpr bool bytes = __has_unique_object_representations(T);
+		if (!_internal_tdd::is_constant_evaluated() && bytes) first = _internal_tdd::mismatch(a, b, n * sizeof(T)) / sizeof(T);
+		else while (first < n && a[first] == b[first]) ++first;
+		if (first == n && na == nb) [[likely]] return expect(true, file, line, msg);
+
+		printer_t p = expect(false, file, line, msg);
+		if (!p) {
+			size_t count = 0;
+			if constexpr(bytes) count = _internal_tdd::count_mismatches(a, b, n, sizeof(T), first);
+			else for (size_t i = first; i < n; ++i) count += !(a[i] == b[i]);
+			_internal_tdd::print_mismatch(a, na, b, nb, sizeof(T), _internal_tdd::element_of<T>(),
+			                             &_internal_tdd::equal_at<T>, first, count);
+		}
+		return p;
+	}
+
+	template<class T>
+	constexpr printer_t range_eq(const char* file, size_t line, const char* msg, const T* a, const T* b, size_t n) {
+		return range_eq(file, line, msg, a, n, b, n);
+	}
+
+	// Anything with data() and size(), or an array.
+	template<class A, class B>
+	constexpr printer_t span_eq(const char* file, size_t line, const char* msg, const A& a, const B& b) {
+		return range_eq(file, line, msg, _internal_tdd::span_data(a), _internal_tdd::span_size(a),
+		                _internal_tdd::span_data(b), _internal_tdd::span_size(b));
+	}
+	// }}}
+
+	// floats {{{
+	namespace _internal_tdd {
+		enum class tolerance { abs, ulps };
+
+		// How many representable values apart a and b are. 0 and -0 are the same.
+		template<class T> requires(sizeof(T) == 4 || sizeof(T) == 8)
+		constexpr unsigned long long ulps_between(T a, T b) {
+			using I = conditional<sizeof(T) == 4, int, long long>;
+			constexpr I max = I(~0ull >> (65 - 8 * sizeof(T)));
+			I i = __builtin_bit_cast(I, a), j = __builtin_bit_cast(I, b);
+			long long x = i < 0 ? -(long long)(i & max) : i, y = j < 0 ? -(long long)(j & max) : j;
+			return x < y ? (unsigned long long)y - (unsigned long long)x : (unsigned long long)x - (unsigned long long)y;
+		}
+
+		// NaN matches only NaN, and infinity only itself.
+		template<class T>
+		constexpr bool within(T a, T b, tolerance t, double tol) {
+			if (a != a || b != b) return a != a && b != b;
+			if (a == b) return true;
+			if (t == tolerance::abs) return (a < b ? b - a : a - b) <= T(tol);
+			if (!__builtin_isfinite(a) || !__builtin_isfinite(b)) return false;  // Infinity is not 1 ulp from the largest finite value.
+			if constexpr(sizeof(T) <= 8) return (double)ulps_between(a, b) <= tol;
+			else return false;
+		}
+
+		// Index of the first of n elements that are not within tol, or n. Checked with AVX2 if the CPU has it.
+		template<class T> size_t first_off(const T* a, const T* b, size_t n, tolerance t, double tol) noexcept;
+
+		// Prints the worst element, how many are off and a histogram of the errors, or only the error of a scalar.
+		template<class T> [[gnu::cold]] void print_off(const T* a, const T* b, size_t n, tolerance t, double tol) noexcept;
+	}
+
+	// a and b, or every element of two spans of float or double. Only NEAR takes long double.
+	template<_internal_tdd::tolerance t, class A, class B>
+	constexpr printer_t near(const char* file, size_t line, const char* msg, const A& a, const B& b, double tol) {
+		if constexpr(_internal_tdd::is_float<A> || _internal_tdd::is_float<B>) {
+			using T = decltype(a - b);
+			static_assert(t == _internal_tdd::tolerance::abs || sizeof(T) <= 8, "ULP_EQ needs float or double");
+			T x = a, y = b;
+			if (_internal_tdd::within(x, y, t, tol)) [[likely]] return expect(true, file, line, msg);
+			printer_t p = expect(false, file, line, msg);
+			if (!p) _internal_tdd::print_off(&x, &y, 1, t, tol);
+			return p;
+		} else {
+			const auto* x = _internal_tdd::span_data(a);
+			const auto* y = _internal_tdd::span_data(b);
+			static_assert(t == _internal_tdd::tolerance::abs || sizeof(*x) <= 8, "ULP_EQ needs float or double");
+			size_t na = _internal_tdd::span_size(a), nb = _internal_tdd::span_size(b), n = na < nb ? na : nb, first = 0;
+			if (_internal_tdd::is_constant_evaluated()) while (first < n && _internal_tdd::within(x[first], y[first], t, tol)) ++first;
+			else first = _internal_tdd::first_off(x, y, n, t, tol);
+			if (first == n && na == nb) [[likely]] return expect(true, file, line, msg);
+
+			printer_t p = expect(false, file, line, msg);
+			if (!p && na != nb) p.print("    sizes differ: %zu and %zu\n", na, nb);
+			if (!p && first < n) _internal_tdd::print_off(x, y, n, t, tol);
+			return p;
+		}
+	}
+	// }}}
+
 	template<class A, class... B> requires(requires(const A& a, const B&... b) { true && ((a == b) && ...); })
 	constexpr printer_t eq(const char* file, size_t line, const char* msg,
 	                       const A& a, const B&... b) {
-		return ((expect(((a == b) && ...), file, line, msg) << a) << ... << b);
+		if (((a == b) && ...)) [[likely]] return expect(true, file, line, msg);
+		return ((expect(false, file, line, msg) << a) << ... << b);
 	}
 }
 
@@ -888,20 +1332,55 @@ namespace tdd {
 #define TEST_INTERNAL_ERROR_MSG_(EXPR) \
 	__FILE__ ":" TEST_INTERNAL_NTOS_(__LINE__) ": error: expected '" #EXPR "'\n"
 
-#define EXPECT(...) tdd::expect((__VA_ARGS__), __FILE__, __LINE__, TEST_INTERNAL_STR_((__VA_ARGS__)))
-#define NEED(...) if (EXPECT(__VA_ARGS__)) return
-
-#define EQ(...) tdd::eq(__FILE__, __LINE__, TEST_INTERNAL_STR_((__VA_ARGS__)), __VA_ARGS__)
-
-#define NE(A, B) EXPECT((A) != (B)) << (A) << (B)
-#define GE(A, B) EXPECT((A) >= (B)) << (A) << (B)
-#define GT(A, B) EXPECT((A) >  (B)) << (A) << (B)
-#define LE(A, B) EXPECT((A) <= (B)) << (A) << (B)
-#define LT(A, B) EXPECT((A) <  (B)) << (A) << (B)
-
-#define DECL_TEST_(CONSTEXPR, CAT, NAME, PARAM, ...)                                                                                                                   \
+// Statements rather than expressions, so that whatever is streamed into them is only evaluated on failure.
+// The switch keeps an else that follows from binding to them.
+#define TEST_INTERNAL_LAZY_(...) switch (0) case 0: default: if (__VA_ARGS__) {} else ::tdd::failed()
+
+#define EXPECT(...) TEST_INTERNAL_LAZY_(tdd::expect((__VA_ARGS__), __FILE__, __LINE__, TEST_INTERNAL_STR_((__VA_ARGS__))))
+#define NEED(...) if (tdd::expect((__VA_ARGS__), __FILE__, __LINE__, TEST_INTERNAL_STR_((__VA_ARGS__)))) return
+
+#define EQ(...) TEST_INTERNAL_LAZY_(tdd::eq(__FILE__, __LINE__, TEST_INTERNAL_STR_((__VA_ARGS__)), __VA_ARGS__))
+
+// N elements from A and B, or all elements of two spans. A failure prints the elements around the first mismatch.
+#define EXPECT_RANGE_EQ(A, B, N) TEST_INTERNAL_LAZY_(tdd::range_eq(__FILE__, __LINE__, #A " == " #B " over " #N " elements", A, B, N))
+#define EQ_SPAN(A, B) TEST_INTERNAL_LAZY_(tdd::span_eq(__FILE__, __LINE__, #A " == " #B " element by element", A, B))
+
+// The block that follows allocates on the heap at most N times on this thread, or not at all. Counted only if tdd.cpp is
+// compiled with TDD_ALLOCS=1.
+#define TEST_INTERNAL_ALLOCS_(N, MSG) \
+	for (::tdd::_internal_tdd::alloc_scope tdd_allocs_(__FILE__, __LINE__, MSG, N); tdd_allocs_.enter();)
+#define EXPECT_MAX_ALLOCS(N) TEST_INTERNAL_ALLOCS_(N, "at most " #N " allocations")
+#define EXPECT_NO_ALLOC TEST_INTERNAL_ALLOCS_(0, "no allocations")
+
+// A and B, or every element of two spans, at most TOL apart, or ULPS representable values apart.
+#define NEAR(A, B, TOL) \
+	TEST_INTERNAL_LAZY_(tdd::near<::tdd::_internal_tdd::tolerance::abs>(__FILE__, __LINE__, #A " == " #B " within " #TOL, A, B, TOL))
+#define ULP_EQ(A, B, ULPS) \
+	TEST_INTERNAL_LAZY_(tdd::near<::tdd::_internal_tdd::tolerance::ulps>(__FILE__, __LINE__, #A " == " #B " within " #ULPS " ulps", A, B, ULPS))
+
+// A and B are evaluated once, and printed on failure.
+#define TEST_INTERNAL_CMP_(A, OP, B)                                                                                           \
+	switch (0) case 0: default:                                                                                                \
+	if (const auto& tdd_a_ = (A); false) {}                                                                                    \
+	else if (const auto& tdd_b_ = (B); tdd::expect(tdd_a_ OP tdd_b_, __FILE__, __LINE__, TEST_INTERNAL_STR_(((A) OP (B))))) {} \
+	else ::tdd::failed() << tdd_a_ << tdd_b_
+
+#define NE(A, B) TEST_INTERNAL_CMP_(A, !=, B)
+#define GE(A, B) TEST_INTERNAL_CMP_(A, >=, B)
+#define GT(A, B) TEST_INTERNAL_CMP_(A, >,  B)
+#define LE(A, B) TEST_INTERNAL_CMP_(A, <=, B)
+#define LT(A, B) TEST_INTERNAL_CMP_(A, <,  B)
+
+#define DECL_TEST_(CONSTEXPR, CAT, THREADS, NAME, PARAM, ...)                                                                                                          \
 	template<class Access> struct tdd_test_## NAME ##_ {                                                                                                               \
-		struct _test_internals_ { using access = Access; constexpr static ::tdd::_internal_tdd::category cat = CAT; };                                                 \
+		struct _test_internals_ {                                                                                                                                      \
+			using access = Access;                                                                                                                                     \
+			constexpr static ::tdd::_internal_tdd::category cat = CAT;                                                                                                 \
+			constexpr static const char* name = #NAME;                                                                                                                 \
+			constexpr static const char* file = __FILE__;                                                                                                              \
+			constexpr static unsigned line = __LINE__;                                                                                                                 \
+			constexpr static unsigned threads = THREADS;                                                                                                               \
+		};                                                                                                                                                             \
 		template<size_t... I> using prv_type = typename decltype(Access::template prv<I...>())::type;                                                                  \
 		template<size_t... I> constexpr static decltype(auto) prv()         { return Access::template prv<I...>(); }                                                   \
 		template<size_t... I> constexpr static decltype(auto) prv(auto&& o) { return Access::template prv<I...>(::tdd::_internal_tdd::forward<decltype(o)>(o)); }      \
@@ -912,13 +1391,18 @@ namespace tdd {
 	CONSTEXPR void tdd_test_## NAME ##_<Access>::body()
 
 
-#define   TESTX(NAME, ...) DECL_TEST_(         , ::tdd::_internal_tdd::category::R,  NAME __VA_OPT__(,) __VA_ARGS__)
-#define  CTESTX(NAME, ...) DECL_TEST_(constexpr, ::tdd::_internal_tdd::category::C,  NAME __VA_OPT__(,) __VA_ARGS__)
-#define CRTESTX(NAME, ...) DECL_TEST_(constexpr, ::tdd::_internal_tdd::category::CR, NAME __VA_OPT__(,) __VA_ARGS__)
+#define   TESTX(NAME, ...) DECL_TEST_(         , ::tdd::_internal_tdd::category::R,  0, NAME __VA_OPT__(,) __VA_ARGS__)
+#define  CTESTX(NAME, ...) DECL_TEST_(constexpr, ::tdd::_internal_tdd::category::C,  0, NAME __VA_OPT__(,) __VA_ARGS__)
+#define CRTESTX(NAME, ...) DECL_TEST_(constexpr, ::tdd::_internal_tdd::category::CR, 0, NAME __VA_OPT__(,) __VA_ARGS__)
+#define  BENCHX(NAME, ...) DECL_TEST_(         , ::tdd::_internal_tdd::category::B,  0, NAME __VA_OPT__(,) __VA_ARGS__)
+#define CONCURRENT_TESTX(NAME, THREADS, ...) DECL_TEST_(, ::tdd::_internal_tdd::category::MT, THREADS, NAME __VA_OPT__(,) __VA_ARGS__)
+#define PROPERTY(NAME, ...) DECL_TEST_(, ::tdd::_internal_tdd::category::P, 0, NAME, void __VA_OPT__(,) __VA_ARGS__)
 
 #define   TEST(NAME, ...)   TESTX(NAME, void __VA_OPT__(, ) __VA_ARGS__)
 #define  CTEST(NAME, ...)  CTESTX(NAME, void __VA_OPT__(, ) __VA_ARGS__)
 #define CRTEST(NAME, ...) CRTESTX(NAME, void __VA_OPT__(, ) __VA_ARGS__)
+#define  BENCH(NAME, ...)  BENCHX(NAME, void __VA_OPT__(, ) __VA_ARGS__)
+#define CONCURRENT_TEST(NAME, THREADS, ...) CONCURRENT_TESTX(NAME, THREADS, void __VA_OPT__(, ) __VA_ARGS__)
 
 #define RUN_ALL()                                                                      \
 	namespace tdd::_internal_tdd {                                                     \